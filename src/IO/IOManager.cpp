@@ -1,5 +1,6 @@
 #include "IOManager.hpp"
 #include <iostream>
+#include "../trace/Console.hpp"
 #include <chrono>
 #include <fstream>
 #include <cstdlib>
@@ -116,8 +117,8 @@ void IOManager::managerLoop() {
             // Incrementa ciclos de I/O no PCB
             req_to_process->process->io_cycles.fetch_add(duration);
 
-            std::cout << "I/O Manager: Processo " << req_to_process->process->pid 
-                    << " executou '" << req_to_process->operation << "'\n";
+            SIM_TRACE(Io, Info, "I/O Manager: Processo " << req_to_process->process->pid
+                    << " executou '" << req_to_process->operation << "'\n");
 
             resultFile << "Processo " << req_to_process->process->pid << " -> " 
                     << req_to_process->operation << " : " << req_to_process->msg << "\n";
@@ -0,0 +1,170 @@
+/*
+  SimConfig.cpp
+  Carregamento da seção "config" do batch.json.
+*/
+#include "SimConfig.hpp"
+#include <fstream>
+#include <iostream>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+static BranchPredictorType parse_predictor_type(const std::string &name, BranchPredictorType fallback) {
+    if (name == "static" || name == "not_taken") return BranchPredictorType::StaticNotTaken;
+    if (name == "bimodal") return BranchPredictorType::Bimodal;
+    if (name == "gshare") return BranchPredictorType::Gshare;
+    std::cerr << "[CONFIG] Preditor de desvio desconhecido: " << name << " (mantido o padrao)\n";
+    return fallback;
+}
+
+static ReplacementPolicy parse_replacement_policy(const std::string &name, ReplacementPolicy fallback) {
+    if (name == "fifo") return ReplacementPolicy::FIFO;
+    if (name == "lru") return ReplacementPolicy::LRU;
+    if (name == "plru") return ReplacementPolicy::PLRU;
+    if (name == "random") return ReplacementPolicy::Random;
+    if (name == "srrip") return ReplacementPolicy::SRRIP;
+    if (name == "brrip") return ReplacementPolicy::BRRIP;
+    std::cerr << "[CONFIG] Politica de substituicao desconhecida: " << name << " (mantido o padrao)\n";
+    return fallback;
+}
+
+static PrefetcherType parse_prefetcher_type(const std::string &name, PrefetcherType fallback) {
+    if (name == "none") return PrefetcherType::None;
+    if (name == "next_line") return PrefetcherType::NextLine;
+    if (name == "stride") return PrefetcherType::Stride;
+    if (name == "stream") return PrefetcherType::Stream;
+    std::cerr << "[CONFIG] Prefetcher desconhecido: " << name << " (mantido o padrao)\n";
+    return fallback;
+}
+
+static PageReplacementPolicy parse_page_replacement(const std::string &name, PageReplacementPolicy fallback) {
+    if (name == "fifo") return PageReplacementPolicy::FIFO;
+    if (name == "clock") return PageReplacementPolicy::Clock;
+    if (name == "aging") return PageReplacementPolicy::Aging;
+    if (name == "wsclock") return PageReplacementPolicy::WSClock;
+    std::cerr << "[CONFIG] Substituicao de paginas desconhecida: " << name << " (mantido o padrao)\n";
+    return fallback;
+}
+
+static DiskType parse_disk_type(const std::string &name, DiskType fallback) {
+    if (name == "weighted") return DiskType::Weighted;
+    if (name == "hdd") return DiskType::HDD;
+    if (name == "flash") return DiskType::Flash;
+    std::cerr << "[CONFIG] Tipo de disco desconhecido: " << name << " (mantido o padrao)\n";
+    return fallback;
+}
+
+static void parse_cache_config(const json &j, CacheConfig &cache) {
+    cache.lineSize = j.value("line_size", cache.lineSize);
+    cache.sets = j.value("sets", cache.sets);
+    cache.ways = j.value("ways", cache.ways);
+    if (j.contains("policy")) cache.policy = parse_replacement_policy(j["policy"].get<std::string>(), cache.policy);
+    cache.hitLatency = j.value("hit_latency", cache.hitLatency);
+    cache.missLatency = j.value("miss_latency", cache.missLatency);
+}
+
+static void parse_console_levels(const json &j, trace::ConsoleLevels &levels) {
+    trace::Level level;
+    if (j.is_string()) {
+        if (trace::level_from_name(j.get<std::string>(), level)) levels.fill(level);
+        else std::cerr << "[CONFIG] Nivel de trace desconhecido: " << j.get<std::string>() << "\n";
+        return;
+    }
+    for (const auto &item : j.items()) {
+        trace::Category category;
+        if (!trace::category_from_name(item.key(), category)) {
+            std::cerr << "[CONFIG] Categoria de trace desconhecida: " << item.key() << "\n";
+            continue;
+        }
+        if (trace::level_from_name(item.value().get<std::string>(), level)) {
+            levels[static_cast<size_t>(category)] = level;
+        } else {
+            std::cerr << "[CONFIG] Nivel de trace desconhecido: " << item.value().get<std::string>() << "\n";
+        }
+    }
+}
+
+bool load_sim_config(const std::string &path, SimConfig &config) {
+    std::ifstream f(path);
+    if (!f.is_open()) return false;
+    try {
+        json j; f >> j;
+        if (!j.contains("config")) return true;
+        const json &c = j["config"];
+
+        if (c.contains("pipeline")) {
+            const json &p = c["pipeline"];
+            config.pipeline.forwarding = p.value("forwarding", config.pipeline.forwarding);
+
+            if (p.contains("branch_predictor")) {
+                const json &b = p["branch_predictor"];
+                BranchPredictorConfig &bp = config.pipeline.branchPredictor;
+                if (b.contains("type")) bp.type = parse_predictor_type(b["type"].get<std::string>(), bp.type);
+                bp.tableBits = b.value("table_bits", bp.tableBits);
+                bp.historyBits = b.value("history_bits", bp.historyBits);
+                bp.btbEntries = b.value("btb_entries", bp.btbEntries);
+            }
+        }
+
+        if (c.contains("memory") && c["memory"].contains("tlb")) {
+            const json &t = c["memory"]["tlb"];
+            TLBConfig &tlb = config.memory.tlb;
+            tlb.entries = t.value("entries", tlb.entries);
+            tlb.associativity = t.value("associativity", tlb.associativity);
+        }
+
+        if (c.contains("memory")) {
+            const json &m = c["memory"];
+            config.memory.mainMemoryBytes = m.value("main_memory_bytes", config.memory.mainMemoryBytes);
+            config.memory.pageSize = m.value("page_size", config.memory.pageSize);
+            if (m.contains("l1")) parse_cache_config(m["l1"], config.memory.l1d);
+            if (m.contains("l1d")) parse_cache_config(m["l1d"], config.memory.l1d);
+            if (m.contains("l1i")) parse_cache_config(m["l1i"], config.memory.l1i);
+            if (m.contains("l2")) parse_cache_config(m["l2"], config.memory.l2);
+            if (m.contains("coherence")) {
+                const json &h = m["coherence"];
+                CoherenceConfig &coherence = config.memory.coherence;
+                coherence.busLatency = h.value("bus_latency", coherence.busLatency);
+                coherence.transferLatency = h.value("transfer_latency", coherence.transferLatency);
+                coherence.invalidateLatency = h.value("invalidate_latency", coherence.invalidateLatency);
+            }
+            if (m.contains("prefetch")) {
+                const json &f = m["prefetch"];
+                PrefetchConfig &prefetch = config.memory.prefetch;
+                if (f.contains("type")) prefetch.type = parse_prefetcher_type(f["type"].get<std::string>(), prefetch.type);
+                prefetch.degree = f.value("degree", prefetch.degree);
+                prefetch.distance = f.value("distance", prefetch.distance);
+                prefetch.tableEntries = f.value("table_entries", prefetch.tableEntries);
+            }
+            if (m.contains("paging")) {
+                const json &g = m["paging"];
+                PagingConfig &paging = config.memory.paging;
+                if (g.contains("replacement")) paging.policy = parse_page_replacement(g["replacement"].get<std::string>(), paging.policy);
+                paging.workingSetWindow = g.value("wsclock_window", paging.workingSetWindow);
+                paging.async = g.value("async", paging.async);
+                paging.shareImages = g.value("share_images", paging.shareImages);
+            }
+            if (m.contains("disk")) {
+                const json &d = m["disk"];
+                DiskConfig &disk = config.memory.disk;
+                if (d.contains("type")) disk.type = parse_disk_type(d["type"].get<std::string>(), disk.type);
+                disk.seekLatency = d.value("seek_latency", disk.seekLatency);
+                disk.rotationalLatency = d.value("rotational_latency", disk.rotationalLatency);
+                disk.transferLatency = d.value("transfer_latency", disk.transferLatency);
+                disk.trackWords = d.value("track_words", disk.trackWords);
+                disk.flashReadLatency = d.value("flash_read_latency", disk.flashReadLatency);
+                disk.flashWriteLatency = d.value("flash_write_latency", disk.flashWriteLatency);
+                disk.image = d.value("image", disk.image);
+                disk.sizeWords = d.value("size_words", disk.sizeWords);
+            }
+        }
+
+        if (c.contains("trace") && c["trace"].contains("console")) {
+            parse_console_levels(c["trace"]["console"], config.trace.console);
+        }
+        return true;
+    } catch (const std::exception &e) {
+        std::cerr << "Erro ao ler a configuracao (" << path << "): " << e.what() << "\n";
+        return false;
+    }
+}
@@ -0,0 +1,181 @@
+#ifndef SIM_CONFIG_HPP
+#define SIM_CONFIG_HPP
+/*
+  SimConfig.hpp
+  Parâmetros ajustáveis do simulador. São lidos da seção opcional "config"
+  do batch.json; o que não aparecer lá mantém o valor padrão declarado aqui.
+
+  Exemplo:
+    "config": {
+      "pipeline": {
+        "forwarding": true,
+        "branch_predictor": { "type": "gshare", "table_bits": 10, "history_bits": 8, "btb_entries": 64 }
+      },
+      "memory": {
+        "main_memory_bytes": 1073741824,
+        "page_size": 256,
+        "tlb": { "entries": 16, "associativity": 4 },
+        "l1d": { "line_size": 16, "sets": 2, "ways": 2, "policy": "lru", "hit_latency": 1 },
+        "l1i": { "sets": 4, "ways": 2, "policy": "lru", "hit_latency": 1 },
+        "l2": { "sets": 16, "ways": 4, "policy": "lru", "hit_latency": 3, "miss_latency": 5 },
+        "coherence": { "bus_latency": 1, "transfer_latency": 2, "invalidate_latency": 1 },
+        "prefetch": { "type": "stream", "degree": 2, "distance": 1, "table_entries": 8 },
+        "paging": { "replacement": "wsclock", "wsclock_window": 256, "async": true, "share_images": true },
+        "disk": { "type": "hdd", "seek_latency": 6, "rotational_latency": 3, "transfer_latency": 1, "track_words": 256,
+                  "image": "output/disk.img", "size_words": 268435456 }
+      },
+      "trace": { "console": { "decode": "off", "memory": "info" } }
+    }
+
+  "l1" é aceito como sinônimo de "l1d". O tamanho de linha de toda a
+  hierarquia é o da L1D.
+
+  "console" também aceita um único nível para todas as categorias ("off",
+  "info" ou "debug"). Só dá para reduzir o que foi compilado (SIM_CONSOLE_TRACE).
+*/
+#include <cstdint>
+#include <string>
+#include "../trace/Console.hpp"
+
+enum class BranchPredictorType : uint8_t {
+    StaticNotTaken,   // "static": sempre segue para pc + 4
+    Bimodal,          // "bimodal": contadores de 2 bits indexados pelo PC
+    Gshare            // "gshare": contadores indexados por PC xor histórico global
+};
+
+struct BranchPredictorConfig {
+    BranchPredictorType type = BranchPredictorType::Bimodal;
+    unsigned tableBits = 10;     // 2^tableBits contadores de 2 bits
+    unsigned historyBits = 8;    // bits de histórico global (gshare)
+    unsigned btbEntries = 64;    // entradas do branch target buffer
+};
+
+struct PipelineConfig {
+    // true: adiantamento EX->EX e MEM->EX, bolha só no load-use.
+    // false: toda dependência RAW com EX/MEM vira bolha (modo só-stall).
+    bool forwarding = true;
+    BranchPredictorConfig branchPredictor;
+};
+
+struct TLBConfig {
+    unsigned entries = 16;        // 0 desliga o TLB
+    unsigned associativity = 4;   // vias por conjunto (0 = totalmente associativo)
+};
+
+// Política de substituição de um nível de cache (cachePolicy.hpp)
+enum class ReplacementPolicy : uint8_t {
+    FIFO,     // "fifo"
+    LRU,      // "lru"
+    PLRU,     // "plru": árvore de bits (vias em potência de 2)
+    Random,   // "random"
+    SRRIP,    // "srrip": re-reference interval prediction estático
+    BRRIP     // "brrip": RRIP bimodal, resistente a varreduras
+};
+
+struct CacheConfig {
+    unsigned lineSize = 16;      // bytes por linha (potência de 2, no máximo uma página)
+    unsigned sets = 2;
+    unsigned ways = 2;
+    ReplacementPolicy policy = ReplacementPolicy::FIFO;
+    // Ciclos cobrados por acerto neste nível e, na L2, pela linha trazida da
+    // RAM (o miss na L1 custa o que cobrar quem entregar a linha).
+    // 0 = deriva dos pesos de memória do processo (memory_weights do PCB).
+    unsigned hitLatency = 0;
+    unsigned missLatency = 0;
+};
+
+// Custos do protocolo MESI entre as L1 (CacheHierarchy.hpp)
+struct CoherenceConfig {
+    unsigned busLatency = 1;          // por transação no barramento (BusRd, BusRdX, BusUpgr)
+    unsigned transferLatency = 2;     // linha entregue por outra L1
+    unsigned invalidateLatency = 1;   // por cópia invalidada em outra L1
+};
+
+// Prefetcher de dados de cada núcleo (Prefetcher.hpp)
+enum class PrefetcherType : uint8_t {
+    None,       // "none"
+    NextLine,   // "next_line"
+    Stride,     // "stride": passo por PC
+    Stream      // "stream": fluxos de linhas vizinhas
+};
+
+struct PrefetchConfig {
+    PrefetcherType type = PrefetcherType::None;
+    unsigned degree = 2;         // linhas pedidas por disparo
+    unsigned distance = 1;       // a primeira linha pedida está distance linhas (ou passos) à frente
+    unsigned tableEntries = 16;  // entradas da tabela de passos / fluxos acompanhados
+};
+
+// Substituição de páginas na RAM (PageReplacement.hpp)
+enum class PageReplacementPolicy : uint8_t {
+    FIFO,     // "fifo": ordem de carga
+    Clock,    // "clock": segunda chance com bits R/D
+    Aging,    // "aging": aproximação de LRU com contadores de 8 bits
+    WSClock   // "wsclock": clock com janela de working set
+};
+
+struct PagingConfig {
+    PageReplacementPolicy policy = PageReplacementPolicy::FIFO;
+    uint64_t workingSetWindow = 256;   // acessos sem uso para a página sair do working set (wsclock)
+    // Falta de página que precisa do disco bloqueia só o processo: o núcleo passa
+    // para outro e a instrução é retomada quando a página chegar (MemoryManager.hpp)
+    bool async = false;
+    // Processos do mesmo program_path dividem as páginas da imagem (copy-on-write)
+    bool shareImages = false;
+};
+
+// Modelo de tempo da memória secundária (SECONDARY_MEMORY.hpp)
+enum class DiskType : uint8_t {
+    Weighted,   // "weighted": cada página transferida custa memory_weights.secondary do processo
+    HDD,        // "hdd": seek + latência rotacional + transferência por palavra
+    Flash       // "flash": latência fixa por página, diferente para leitura e escrita
+};
+
+struct DiskConfig {
+    DiskType type = DiskType::Weighted;
+    unsigned seekLatency = 6;          // hdd: cabeça vai para outra trilha
+    unsigned rotationalLatency = 3;    // hdd: espera média pelo setor (meia volta)
+    unsigned transferLatency = 1;      // hdd: por palavra transferida
+    unsigned trackWords = 256;         // hdd: palavras por trilha
+    unsigned flashReadLatency = 8;     // flash: leitura de uma página
+    unsigned flashWriteLatency = 20;   // flash: programação de uma página
+    // Arquivo de imagem mapeado, espaço de trabalho do swap (vazio = disco
+    // em memória, limitado a MAX_SECONDARY_MEMORY_SIZE palavras) e tamanho
+    // em palavras (0 = o tamanho passado ao MemoryManager)
+    std::string image;
+    uint64_t sizeWords = 0;
+};
+
+struct MemoryConfig {
+    // RAM simulada em bytes (até 4 GiB menos uma página). Só o que os
+    // processos tocam ocupa memória do hospedeiro.
+    uint64_t mainMemoryBytes = 512;
+    // Bytes por página: potência de 2 de 16 a 4096. As linhas de cache ficam
+    // limitadas a uma página.
+    unsigned pageSize = 32;
+    TLBConfig tlb;   // TLB de cada núcleo
+    CacheConfig l1d;                 // L1 de dados privada de cada núcleo (LW/SW)
+    CacheConfig l1i{16, 4, 2};       // L1 de instruções privada de cada núcleo (busca)
+    CacheConfig l2{16, 16, 4, ReplacementPolicy::LRU};  // L2 compartilhada
+    CoherenceConfig coherence;
+    PrefetchConfig prefetch;
+    PagingConfig paging;
+    DiskConfig disk;
+};
+
+struct TraceConfig {
+    // Nível de cada categoria de mensagens no console (limitado ao compilado)
+    trace::ConsoleLevels console = trace::COMPILED_LEVELS;
+};
+
+struct SimConfig {
+    PipelineConfig pipeline;
+    MemoryConfig memory;
+    TraceConfig trace;
+};
+
+// Lê a seção "config" do arquivo (normalmente o batch.json).
+// Retorna false se o arquivo não abrir ou não for um JSON válido.
+bool load_sim_config(const std::string &path, SimConfig &config);
+
+#endif // SIM_CONFIG_HPP
@@ -0,0 +1,55 @@
+#include "BranchPredictor.hpp"
+
+BranchPredictor::BranchPredictor(const BranchPredictorConfig &cfg) : config(cfg) {
+    if (config.tableBits == 0 || config.tableBits > 20) config.tableBits = 10;
+    if (config.historyBits > config.tableBits) config.historyBits = config.tableBits;
+    if (config.btbEntries == 0) config.btbEntries = 1;
+
+    counterMask = (1u << config.tableBits) - 1;
+    historyMask = (1u << config.historyBits) - 1;
+    counters.assign(static_cast<size_t>(counterMask) + 1, 1); // fracamente "não segue"
+    btb.assign(config.btbEntries, BtbEntry{});
+}
+
+size_t BranchPredictor::counterIndex(uint32_t pc) const {
+    uint32_t idx = pc >> 2;
+    if (config.type == BranchPredictorType::Gshare) idx ^= history;
+    return idx & counterMask;
+}
+
+BranchPrediction BranchPredictor::predict(uint32_t pc) const {
+    BranchPrediction prediction;
+    if (config.type == BranchPredictorType::StaticNotTaken) return prediction;
+
+    const BtbEntry &entry = btb[btbIndex(pc)];
+    if (!entry.valid || entry.tag != pc) return prediction;
+
+    prediction.taken = entry.unconditional || counters[counterIndex(pc)] >= 2;
+    prediction.target = entry.target;
+    return prediction;
+}
+
+void BranchPredictor::update(uint32_t pc, bool taken, uint32_t target, bool unconditional) {
+    if (config.type == BranchPredictorType::StaticNotTaken) return;
+
+    if (!unconditional) {
+        uint8_t &counter = counters[counterIndex(pc)];
+        if (taken && counter < 3) counter++;
+        if (!taken && counter > 0) counter--;
+        history = ((history << 1) | (taken ? 1u : 0u)) & historyMask;
+    }
+
+    // O BTB só aloca entrada para desvios que já foram tomados alguma vez
+    BtbEntry &entry = btb[btbIndex(pc)];
+    if (taken) {
+        entry.tag = pc;
+        entry.target = target;
+        entry.valid = true;
+        entry.unconditional = unconditional;
+    }
+}
+
+void BranchPredictor::invalidate(uint32_t pc) {
+    BtbEntry &entry = btb[btbIndex(pc)];
+    if (entry.valid && entry.tag == pc) entry.valid = false;
+}
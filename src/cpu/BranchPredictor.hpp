@@ -0,0 +1,58 @@
+#ifndef BRANCH_PREDICTOR_HPP
+#define BRANCH_PREDICTOR_HPP
+/*
+  BranchPredictor.hpp
+  Unidade de previsão de desvios consultada pelo Fetch.
+
+  - predict(): com o PC buscado, diz se o desvio deve ser seguido e para onde.
+    O alvo vem do BTB (branch target buffer); sem entrada no BTB a previsão
+    é sempre pc + 4. A direção vem do tipo configurado:
+      * StaticNotTaken: nunca segue o desvio (comportamento antigo);
+      * Bimodal: contador saturado de 2 bits indexado pelo PC;
+      * Gshare: contador indexado por PC xor histórico global dos desvios.
+  - update(): resultado real, informado pelo EX quando o desvio é resolvido.
+  - invalidate(): descarta a entrada do BTB que previu desvio para uma
+    instrução que o Decode descobriu não ser desvio (outro processo ou código
+    reescrito no mesmo PC).
+
+  Cada núcleo possui o seu preditor, compartilhado pelos processos que rodam nele.
+*/
+#include <cstdint>
+#include <vector>
+#include "../config/SimConfig.hpp"
+
+struct BranchPrediction {
+    bool taken = false;
+    uint32_t target = 0;
+};
+
+class BranchPredictor {
+public:
+    explicit BranchPredictor(const BranchPredictorConfig &config = BranchPredictorConfig{});
+
+    BranchPrediction predict(uint32_t pc) const;
+    void update(uint32_t pc, bool taken, uint32_t target, bool unconditional);
+    void invalidate(uint32_t pc);
+
+    BranchPredictorType type() const { return config.type; }
+
+private:
+    struct BtbEntry {
+        uint32_t tag = 0;
+        uint32_t target = 0;
+        bool valid = false;
+        bool unconditional = false;
+    };
+
+    size_t counterIndex(uint32_t pc) const;
+    size_t btbIndex(uint32_t pc) const { return (pc >> 2) % btb.size(); }
+
+    BranchPredictorConfig config;
+    std::vector<uint8_t> counters;   // 0,1 = não segue; 2,3 = segue
+    std::vector<BtbEntry> btb;
+    uint32_t history = 0;
+    uint32_t counterMask = 0;
+    uint32_t historyMask = 0;
+};
+
+#endif // BRANCH_PREDICTOR_HPP
@@ -4,44 +4,37 @@
 #include "../memory/MemoryManager.hpp"
 #include "PCB.hpp"
 #include "../IO/IOManager.hpp"
-#include <bitset>
+#include "../trace/Console.hpp"
+#include "../trace/Trace.hpp"
 #include <cmath>
 #include <stdexcept>
 #include <iostream>
 #include <algorithm>
+#include <array>
 #include <sstream>
 #include <vector>
 #include <fstream>
 #include <mutex>
 
-static std::mutex log_mutex;
 using namespace std;
 
 
 
-//Implementação thread-safe de log_operation (Recebe e usa o PID)
-void Control_Unit::log_operation(const std::string &msg, int pid) {
-    std::lock_guard<std::mutex> lock(log_mutex);
-    
-    // Usa o PID real para criar um arquivo de log único por processo
-    std::ostringstream oss;
-    oss << "output/trace_logs/temp_" << pid << ".log"; 
-
-    std::ofstream fout(oss.str(), std::ios::app);
-    if (fout.is_open()) {
-        fout << msg << " [PID:" << pid << "]\n";
-    }
-}
-
-static uint32_t binaryStringToUint(const std::string &bin) {
-    if (bin.empty()) return 0;
-    uint32_t value = 0;
-    for (char c : bin) {
-        value <<= 1;
-        if (c == '1') value |= 1u;
-        else if (c != '0') throw std::invalid_argument("binary");
-    }
-    return value;
+// Registro da operação de ULA no trace (sem IO nem alocação; o texto é gerado depois)
+void Control_Unit::trace_operation(const Instruction_Data &data, ControlContext &context, uint8_t dst, int32_t a, int32_t b, int32_t result) {
+    trace::Record record;
+    record.cycle = context.process.pipeline_cycles.load(std::memory_order_relaxed);
+    record.pid = context.process.pid;
+    record.pc = data.pc;
+    record.event = trace::Event::Alu;
+    record.opcode = static_cast<uint8_t>(data.op);
+    record.dst = dst;
+    record.src1 = data.rs;
+    record.src2 = data.rt;
+    record.a = a;
+    record.b = b;
+    record.result = result;
+    trace::emit(record);
 }
 
 static int32_t signExtend16(uint16_t v) {
@@ -49,84 +42,137 @@ static int32_t signExtend16(uint16_t v) {
     else return (int32_t)(v & 0x0000FFFFu);
 }
 
-static std::string regIndexToBitString(uint32_t idx) {
-    std::string s(5, '0');
-    for (int i = 4; i >= 0; --i) s[4 - i] = ((idx >> i) & 1) ? '1' : '0';
-    return s;
-}
-
-static std::string toBinStr(uint32_t v, int width) {
-    std::string s(width, '0');
-    for (int i = 0; i < width; ++i) s[width - 1 - i] = ((v >> i) & 1) ? '1' : '0';
-    return s;
-}
-
 static inline void account_pipeline_cycle(PCB &p) { p.pipeline_cycles.fetch_add(1); }
 static inline void account_stage(PCB &p) { p.stage_invocations.fetch_add(1); }
 
-string Control_Unit::Get_immediate(const uint32_t instruction) {
-    uint16_t imm = static_cast<uint16_t>(instruction & 0xFFFFu);
-    return std::bitset<16>(imm).to_string();
+int32_t Control_Unit::Get_immediate(const uint32_t instruction) {
+    return signExtend16(static_cast<uint16_t>(instruction & 0xFFFFu));
 }
 
-string Control_Unit::Get_destination_Register(const uint32_t instruction) {
-    uint32_t rd = (instruction >> 11) & 0x1Fu;
-    return regIndexToBitString(rd);
+uint8_t Control_Unit::Get_destination_Register(const uint32_t instruction) {
+    return static_cast<uint8_t>((instruction >> 11) & 0x1Fu);
 }
 
-string Control_Unit::Get_target_Register(const uint32_t instruction) {
-    uint32_t rt = (instruction >> 16) & 0x1Fu;
-    return regIndexToBitString(rt);
+uint8_t Control_Unit::Get_target_Register(const uint32_t instruction) {
+    return static_cast<uint8_t>((instruction >> 16) & 0x1Fu);
 }
 
-string Control_Unit::Get_source_Register(const uint32_t instruction) {
-    uint32_t rs = (instruction >> 21) & 0x1Fu;
-    return regIndexToBitString(rs);
+uint8_t Control_Unit::Get_source_Register(const uint32_t instruction) {
+    return static_cast<uint8_t>((instruction >> 21) & 0x1Fu);
 }
 
-string Control_Unit::Identificacao_instrucao(uint32_t instruction, hw::REGISTER_BANK &registers) {
+Opcode Control_Unit::Identificacao_instrucao(uint32_t instruction, hw::REGISTER_BANK &registers) {
     (void)registers; 
     uint32_t opcode = (instruction >> 26) & 0x3Fu;
-    
-    switch (opcode) {
-        case 0x00: { // R-type
-            uint32_t funct = instruction & 0x3Fu;
-            if (funct == 0x20) return "ADD";
-            if (funct == 0x22) return "SUB";
-            if (funct == 0x18) return "MULT";
-            if (funct == 0x1A) return "DIV";
-            return ""; // NOP
-        }
-        case 0x02: return "J";        
-        case 0x03: return "JAL";
-        case 0x04: return "BEQ";
-        case 0x05: return "BNE";
-        case 0x08: return "ADDI";     
-        case 0x09: return "ADDIU";    
-        case 0x0F: return "LUI";      
-        case 0x0C: return "ANDI";     
-        case 0x0A: return "SLTI";     
-        case 0x23: return "LW";       
-        case 0x2B: return "SW";       
-        case 0x0E: return "LI";       
-        case 0x10: return "PRINT";    
-        case 0x3F: return "END";
-        case 0x07: return "BGT";
-        case 0x01: return "BLT"; 
-        default: return ""; 
+
+    // R-type é identificado pelo funct; os demais pelo opcode primário (ISA.hpp)
+    if (opcode == 0x00) return FUNCT_TABLE[instruction & 0x3Fu];
+    return PRIMARY_OPCODE_TABLE[opcode];
+}
+
+MicroOp Control_Unit::Build_MicroOp(uint32_t instruction, hw::REGISTER_BANK &registers) {
+    MicroOp uop;
+    uop.raw = instruction;
+    uop.op = Identificacao_instrucao(instruction, registers);
+
+    switch (isaInfo(uop.op).format) {
+        case InstrFormat::R:
+            uop.rs = Get_source_Register(instruction);
+            uop.rt = Get_target_Register(instruction);
+            uop.rd = Get_destination_Register(instruction);
+            break;
+        case InstrFormat::I:
+            uop.rs = Get_source_Register(instruction);
+            uop.rt = Get_target_Register(instruction);
+            uop.imm = Get_immediate(instruction);
+            break;
+        case InstrFormat::J:
+            uop.imm = static_cast<int32_t>(instruction & 0x03FFFFFFu);
+            break;
+        case InstrFormat::P:
+            uop.rt = Get_target_Register(instruction);
+            uop.imm = Get_immediate(instruction);
+            break;
+        case InstrFormat::None:
+            break;
+    }
+    return uop;
+}
+
+// Registrador escrito pela instrução (0 = nenhum, já que $zero nunca gera hazard)
+static uint8_t get_dest_reg_for_hazard(const Instruction_Data& instr) {
+    switch (isaInfo(instr.op).dest) {
+        case InstrDest::RD: return instr.rd;
+        case InstrDest::RT: return instr.rt;
+        default:            return 0;
+    }
+}
+
+// Estágio ao fim do qual o resultado existe e pode ser adiantado: o LW só tem o
+// dado depois do acesso à memória; as demais (ULA, LI, LA) já no EX
+static int result_ready_stage(const InstrInfo& info) {
+    return info.mem == MemUnit::Load ? STAGE_MEM : STAGE_EX;
+}
+
+// Estágio em cujo início o operando precisa estar disponível. O dado do SW
+// (rt) só é lido na escrita em memória; o resto é consumido no EX
+static int operand_use_stage(const InstrInfo& info, bool isRt) {
+    return (isRt && info.wb == WbUnit::Store) ? STAGE_WB : STAGE_EX;
+}
+
+// --- Tabelas de despacho por estágio, geradas a partir de ISA_TABLE ---
+using StageHandler = void (Control_Unit::*)(Instruction_Data &, ControlContext &);
+
+static constexpr StageHandler execute_handler(ExecUnit unit) {
+    switch (unit) {
+        case ExecUnit::Immediate:  return &Control_Unit::Execute_Immediate_Operation;
+        case ExecUnit::Arithmetic: return &Control_Unit::Execute_Aritmetic_Operation;
+        case ExecUnit::Branch:     return &Control_Unit::Execute_Loop_Operation;
+        case ExecUnit::Print:      return &Control_Unit::Execute_Operation;
+        default:                   return nullptr;
     }
 }
 
-static string get_dest_reg_for_hazard(const Instruction_Data& instr) {
-    if (instr.op == "ADD" || instr.op == "SUB" || instr.op == "MULT" || instr.op == "DIV") return instr.destination_register;
-    if (instr.op == "ADDI" || instr.op == "ADDIU" || instr.op == "LW" || instr.op == "LI" || instr.op == "LUI" || instr.op == "SLTI" || instr.op == "LA") return instr.target_register;
-    return "";
+static constexpr StageHandler memory_handler(MemUnit unit) {
+    switch (unit) {
+        case MemUnit::Load:          return &Control_Unit::Memory_Load_Operation;
+        case MemUnit::LoadImmediate: return &Control_Unit::Memory_Immediate_Operation;
+        default:                     return nullptr;
+    }
 }
 
+static constexpr StageHandler write_back_handler(WbUnit unit) {
+    switch (unit) {
+        case WbUnit::Store: return &Control_Unit::Write_Back_Store_Operation;
+        default:            return nullptr;
+    }
+}
+
+static constexpr auto EXECUTE_TABLE = [] {
+    std::array<StageHandler, OPCODE_COUNT> t{};
+    for (size_t i = 0; i < OPCODE_COUNT; ++i) t[i] = execute_handler(ISA_TABLE[i].ex);
+    return t;
+}();
+
+static constexpr auto MEMORY_TABLE = [] {
+    std::array<StageHandler, OPCODE_COUNT> t{};
+    for (size_t i = 0; i < OPCODE_COUNT; ++i) t[i] = memory_handler(ISA_TABLE[i].mem);
+    return t;
+}();
+
+static constexpr auto WRITE_BACK_TABLE = [] {
+    std::array<StageHandler, OPCODE_COUNT> t{};
+    for (size_t i = 0; i < OPCODE_COUNT; ++i) t[i] = write_back_handler(ISA_TABLE[i].wb);
+    return t;
+}();
+
 void Control_Unit::Fetch(ControlContext &context) {
     account_stage(context.process);
+    this->pipe.at(context.counter).pc = context.registers.pc.value;
     context.registers.mar.write(context.registers.pc.value);
-    uint32_t instr = context.memManager.read(context.registers.mar.read(), context.process);
+    uint32_t instr = context.memManager.fetch(context.registers.mar.read(), context.process, this->port);
+    // Página de código ainda no disco: o ciclo é refeito a partir do IF quando ela chegar
+    if (context.process.pending_page >= 0) return;
     context.registers.ir.write(instr);
 
     if (instr == 0 && context.registers.pc.value > 10000) {
@@ -137,314 +183,328 @@ void Control_Unit::Fetch(ControlContext &context) {
         return;
     }
     
+    // O END não avança o PC; quem encerra o programa é o Decode, porque esta busca
+    // ainda pode estar no caminho errado de um desvio
     const uint32_t END_SENTINEL = 0b11111100000000000000000000000000u;
     if (instr == END_SENTINEL) {
-        context.endProgram = true;
         return;
     }
-    context.registers.pc.write(context.registers.pc.value + 4);
+
+    Instruction_Data &slot = this->pipe.at(context.counter);
+    BranchPrediction prediction = this->predictor.predict(slot.pc);
+    slot.predictedTaken = prediction.taken;
+    slot.predictedTarget = prediction.target;
+    context.registers.pc.write(prediction.taken ? prediction.target : context.registers.pc.value + 4);
 }
 
-void Control_Unit::Decode(hw::REGISTER_BANK &registers, Instruction_Data &data) {
+void Control_Unit::Decode(Instruction_Data &data, ControlContext &context) {
+    hw::REGISTER_BANK &registers = context.registers;
     uint32_t instruction = registers.ir.read();
-    data.rawInstruction = instruction;
-    data.op = Identificacao_instrucao(instruction, registers);
-
-    // Log para debug, sei que não é a melhor maneira, porém estou com preguiça de debugar.
-    std::cout << "[DECODE] PC-4: " << (registers.pc.read()-4) << " Raw: " << std::hex << instruction << " OP: " << data.op << std::dec << "\n";
-
-    if (data.op == "BUBBLE" || data.op == "") return;
-
-    if (data.op == "ADD" || data.op == "SUB" || data.op == "MULT" || data.op == "DIV") {
-        data.source_register = Get_source_Register(instruction);
-        data.target_register = Get_target_Register(instruction);
-        data.destination_register = Get_destination_Register(instruction);
-    } else if (data.op == "ADDI" || data.op == "ADDIU" ||
-               data.op == "LI" || data.op == "LW" || data.op == "LA" || data.op == "SW" ||
-               data.op == "BGTI" || data.op == "BLTI" || data.op == "BEQ" || data.op == "BNE" ||
-               data.op == "BGT"  || data.op == "BLT" || data.op == "SLTI" || data.op == "LUI") {
-        data.source_register = Get_source_Register(instruction);   
-        data.target_register = Get_target_Register(instruction);   
-        data.addressRAMResult = Get_immediate(instruction);
-        uint16_t imm16 = static_cast<uint16_t>(instruction & 0xFFFFu);
-        data.immediate = signExtend16(imm16);
-    } else if (data.op == "J") {
-        uint32_t instr26 = instruction & 0x03FFFFFFu;
-        data.addressRAMResult = std::bitset<26>(instr26).to_string();
-        data.immediate = static_cast<int32_t>(instr26);
-    } else if (data.op == "PRINT") {
-        data.target_register = Get_target_Register(instruction);
-        std::string imm = Get_immediate(instruction);
-        bool allZero = true; for(char c : imm) if(c!='0') allZero=false;
-        if (!allZero) {
-            data.addressRAMResult = imm;
-            uint16_t imm16 = static_cast<uint16_t>(binaryStringToUint(imm));
-            data.immediate = signExtend16(imm16);
+
+    // Palavra zerada (flush de desvio) vira NOP sem passar pelo cache.
+    // Caso contrário reaproveita o micro-op do mesmo PC se a palavra não mudou.
+    if (instruction == 0) {
+        static_cast<MicroOp&>(data) = MicroOp{};
+    } else {
+        const MicroOp *cached = context.process.decodeCache.lookup(data.pc);
+        if (cached != nullptr && cached->raw == instruction) {
+            static_cast<MicroOp&>(data) = *cached;
         } else {
-            data.addressRAMResult.clear();
-            data.immediate = 0;
+            static_cast<MicroOp&>(data) = Build_MicroOp(instruction, registers);
+            context.process.decodeCache.insert(data.pc, data);
         }
     }
 
-    // Detecção de hazards simples (RAW) - insere bolha se necessário
-    std::string read_reg1 = "";
-    std::string read_reg2 = "";
+    SIM_TRACE(Decode, Debug, "[DECODE] PC-4: " << (registers.pc.read()-4) << " Raw: " << std::hex << instruction << " OP: " << opcodeName(data.op) << std::dec << "\n");
 
-    if (data.op == "ADD" || data.op == "SUB" || data.op == "MULT" || data.op == "DIV" || 
-        data.op == "BEQ" || data.op == "BNE" || data.op == "BGT" || data.op == "BLT" || data.op == "SW") {
-        read_reg1 = data.source_register;
-        read_reg2 = data.target_register;
-    }
-    else if (data.op == "ADDI" || data.op == "ADDIU" || data.op == "LW" || data.op == "SLTI") {
-        read_reg1 = data.source_register;
+    // O BTB previu desvio para algo que não é desvio (inclusive NOP): volta para pc + 4.
+    // O IF deste ciclo roda depois do ID, então nenhuma instrução errada chega a ser buscada
+    if (data.predictedTaken && isaInfo(data.op).ex != ExecUnit::Branch) {
+        this->predictor.invalidate(data.pc);
+        data.predictedTaken = false;
+        registers.pc.write(data.pc + 4);
     }
-    else if (data.op == "PRINT") {
-        read_reg1 = data.target_register;
+
+    if (data.op == Opcode::BUBBLE || data.op == Opcode::NOP) return;
+
+    // O END só encerra o programa no ID: os desvios mais antigos já foram resolvidos
+    // no EX deste ciclo, então ele não pode estar no caminho errado. As buscas
+    // repetidas do mesmo END durante o esvaziamento viram bolha.
+    if (data.op == Opcode::END) {
+        if (context.endProgram) data.op = Opcode::BUBBLE;
+        context.endProgram = true;
+        return;
     }
 
-    int current_idx = this->data.size() - 1;
-    
-    
-    if (current_idx - 1 >= 0) {
-        Instruction_Data& exec_instr = this->data[current_idx - 1];
-        if (exec_instr.op != "BUBBLE" && !exec_instr.op.empty()) {
-            string dest = get_dest_reg_for_hazard(exec_instr);
-            if (!dest.empty() && dest != "00000") {
-                if ((!read_reg1.empty() && read_reg1 == dest) || (!read_reg2.empty() && read_reg2 == dest)) {
-                    data.op = "BUBBLE";
-                    data.rawInstruction = 0;
-                    registers.pc.write(registers.pc.read() - 4);
-                    return;
-                }
+    // Detecção de hazards RAW contra as instruções em EX (distância 1) e MEM (distância 2).
+    // No modo só-stall qualquer dependência vira bolha; com forwarding só para quando
+    // o valor ainda não existe no ciclo em que o operando é consumido (load-use).
+    const InstrInfo &info = isaInfo(data.op);
+    const uint8_t read_regs[2] = {
+        static_cast<uint8_t>((info.reads & READS_RS) ? data.rs : 0),
+        static_cast<uint8_t>((info.reads & READS_RT) ? data.rt : 0)
+    };
+
+    int current_idx = context.counter - 1;
+    int stall_only_bubbles = 0;   // bolhas que o modo só-stall inseriria
+    bool stall = false;
+    bool load_use = false;
+    uint64_t fwd_ex_ex = 0, fwd_mem_ex = 0;
+
+    for (int distance = 1; distance <= 2; ++distance) {
+        if (current_idx - distance < 0) break;
+        const Instruction_Data& older = this->pipe.at(current_idx - distance);
+        if (older.op == Opcode::BUBBLE || older.op == Opcode::NOP) continue;
+
+        uint8_t dest = get_dest_reg_for_hazard(older);
+        if (dest == 0) continue;
+
+        for (int operand = 0; operand < 2; ++operand) {
+            if (read_regs[operand] != dest) continue;
+
+            stall_only_bubbles = std::max(stall_only_bubbles, 3 - distance);
+            if (!this->config.forwarding) {
+                stall = true;
+            } else if (distance + operand_use_stage(info, operand == 1) <= result_ready_stage(isaInfo(older.op))) {
+                stall = true;
+                load_use = true;
+            } else if (distance == 1) {
+                fwd_ex_ex++;
+            } else {
+                fwd_mem_ex++;
             }
         }
     }
 
-    if (current_idx - 2 >= 0) {
-        Instruction_Data& mem_instr = this->data[current_idx - 2];
-        if (mem_instr.op != "BUBBLE" && !mem_instr.op.empty()) {
-            string dest = get_dest_reg_for_hazard(mem_instr);
-            if (!dest.empty() && dest != "00000") {
-                if ((!read_reg1.empty() && read_reg1 == dest) || (!read_reg2.empty() && read_reg2 == dest)) {
-                    data.op = "BUBBLE";
-                    data.rawInstruction = 0;
-                    registers.pc.write(registers.pc.read() - 4);
-                    return;
-                }
-            }
-        }
+    if (stall) {
+        data.op = Opcode::BUBBLE;
+        data.raw = 0;
+        registers.pc.write(data.pc);
+        context.process.stall_bubbles++;
+        if (load_use) context.process.load_use_stalls++;
+        return;
+    }
+
+    if (stall_only_bubbles > 0) {
+        context.process.bubbles_avoided += stall_only_bubbles;
+        context.process.forwards_ex_ex += fwd_ex_ex;
+        context.process.forwards_mem_ex += fwd_mem_ex;
     }
 }
 
 
-void Control_Unit::Execute_Immediate_Operation(ControlContext &context, Instruction_Data &data) {
-    if (data.op.empty() || data.op == "BUBBLE") return;
+void Control_Unit::Execute_Immediate_Operation(Instruction_Data &data, ControlContext &context) {
     hw::REGISTER_BANK &registers = context.registers; // Acessa os registradores via contexto
     
-    std::string name_rs = this->map.getRegisterName(binaryStringToUint(data.source_register));
-    std::string name_rt = this->map.getRegisterName(binaryStringToUint(data.target_register));
-    int32_t val_rs = registers.readRegister(name_rs);
-    int32_t imm = data.immediate; 
-    std::ostringstream ss;
+    int32_t val_rs = registers.read(data.rs);
+    int32_t imm = data.imm; 
+    int32_t result = 0;
     
-    if (data.op == "ADDI" || data.op == "ADDIU") {
-        ALU alu; alu.A = val_rs; alu.B = imm; alu.op = ADD; alu.calculate();
-        registers.writeRegister(name_rt, alu.result);
-        ss << "[IMM] " << data.op << " " << name_rt << " = " << name_rs << "(" << val_rs << ") + " << imm << " -> " << alu.result;
-        log_operation(ss.str(), context.process.pid); return; 
-    }
-    if (data.op == "SLTI") {
-        int32_t res = (val_rs < imm) ? 1 : 0; registers.writeRegister(name_rt, res);
-        ss << "[IMM] SLTI " << name_rt << " = (" << name_rs << "(" << val_rs << ") < " << imm << ") ? 1 : 0 -> " << res;
-        log_operation(ss.str(), context.process.pid); return; 
-    }
-    if (data.op == "LUI") {
-        uint32_t uimm = static_cast<uint32_t>(static_cast<uint16_t>(imm));
-        int32_t val = static_cast<int32_t>(uimm << 16); registers.writeRegister(name_rt, val);
-        ss << "[IMM] LUI " << name_rt << " = (0x" << std::hex << imm << " << 16) -> 0x" << val << std::dec;
-        log_operation(ss.str(), context.process.pid); return; 
-    }
-    if (data.op == "LI") {
-        registers.writeRegister(name_rt, imm);
-        ss << "[IMM] LI " << name_rt << " = " << imm;
-        log_operation(ss.str(), context.process.pid); return; 
+    switch (data.op) {
+        case Opcode::ADDI: case Opcode::ADDIU: case Opcode::SLTI: {
+            ALU alu; alu.A = val_rs; alu.B = imm; alu.op = isaInfo(data.op).alu; alu.calculate();
+            result = alu.result;
+            break;
+        }
+        case Opcode::LUI: {
+            uint32_t uimm = static_cast<uint32_t>(static_cast<uint16_t>(imm));
+            result = static_cast<int32_t>(uimm << 16);
+            break;
+        }
+        case Opcode::LI: {
+            result = imm;
+            break;
+        }
+        default:
+            return;
     }
+    registers.write(data.rt, result);
+    trace_operation(data, context, data.rt, val_rs, imm, result);
 }
 
-void Control_Unit::Execute_Aritmetic_Operation(ControlContext &context, Instruction_Data &data) {
-    if (data.op.empty() || data.op == "BUBBLE") return;
+void Control_Unit::Execute_Aritmetic_Operation(Instruction_Data &data, ControlContext &context) {
     hw::REGISTER_BANK &registers = context.registers; // Acessa os registradores via contexto
     
-    std::string name_rs = this->map.getRegisterName(binaryStringToUint(data.source_register));
-    std::string name_rt = this->map.getRegisterName(binaryStringToUint(data.target_register));
-    std::string name_rd = this->map.getRegisterName(binaryStringToUint(data.destination_register));
-    int32_t val_rs = registers.readRegister(name_rs);
-    int32_t val_rt = registers.readRegister(name_rt);
-    ALU alu; alu.A = val_rs; alu.B = val_rt;
-    if (data.op == "ADD") alu.op = ADD;
-    else if (data.op == "SUB") alu.op = SUB;
-    else if (data.op == "MULT") alu.op = MUL;
-    else if (data.op == "DIV") alu.op = DIV;
-    else return;
-    alu.calculate(); registers.writeRegister(name_rd, alu.result);
-    std::ostringstream ss;
-    ss << "[ARIT] " << data.op << " " << name_rd << " = " << name_rs << "(" << val_rs << ") " << data.op << " " << name_rt << "(" << val_rt << ") = " << alu.result;
-    log_operation(ss.str(), context.process.pid); 
+    int32_t val_rs = registers.read(data.rs);
+    int32_t val_rt = registers.read(data.rt);
+    ALU alu; alu.A = val_rs; alu.B = val_rt; alu.op = isaInfo(data.op).alu;
+    alu.calculate(); registers.write(data.rd, alu.result);
+    trace_operation(data, context, data.rd, val_rs, val_rt, alu.result);
 }
 
 
 void Control_Unit::Execute_Operation(Instruction_Data &data, ControlContext &context) {
-    if (data.op == "PRINT") {
-        if (!data.target_register.empty()) {
-            string name = this->map.getRegisterName(binaryStringToUint(data.target_register));
-            int value = context.registers.readRegister(name);
-            auto req = std::make_unique<IORequest>();
-            req->msg = std::to_string(value);
-            req->process = &context.process;
-            context.ioRequests.push_back(std::move(req));
-            std::cout << "[PRINT-REQ] PRINT REG " << name << " value=" << value << " (pid=" << context.process.pid << ")\n";
-            if (context.printLock) {
-                context.process.state = State::Blocked;
-                context.endExecution = true;
-            }
-        }
+    int value = context.registers.read(data.rt);
+    auto req = std::make_unique<IORequest>();
+    req->msg = std::to_string(value);
+    req->process = &context.process;
+    context.ioRequests.push_back(std::move(req));
+    SIM_TRACE(Io, Info, "[PRINT-REQ] PRINT REG " << hw::REGISTER_BANK::gprName(data.rt) << " value=" << value << " (pid=" << context.process.pid << ")\n");
+    if (context.printLock) {
+        context.process.state = State::Blocked;
+        context.endExecution = true;
     }
 }
 
-void Control_Unit::Execute_Loop_Operation(hw::REGISTER_BANK &registers, Instruction_Data &data,
-                                          int &counter, int &counterForEnd, bool &programEnd,
-                                          MemoryManager &memManager, PCB &process) {
-    if (data.op.empty() || data.op == "BUBBLE") return;
+void Control_Unit::Execute_Loop_Operation(Instruction_Data &data, ControlContext &context) {
+    hw::REGISTER_BANK &registers = context.registers;
 
-    string name_rs = this->map.getRegisterName(binaryStringToUint(data.source_register));
-    string name_rt = this->map.getRegisterName(binaryStringToUint(data.target_register));
-    ALU alu;
-    alu.A = registers.readRegister(name_rs);
-    alu.B = registers.readRegister(name_rt);
-    
     bool jump = false;
-    if (data.op == "BEQ") { alu.op = BEQ; alu.calculate(); if (alu.result == 1) jump = true; }
-    else if (data.op == "BNE") { alu.op = BNE; alu.calculate(); if (alu.result == 1) jump = true; }
-    else if (data.op == "J") { jump = true; }
-    else if (data.op == "BLT") { alu.op = BLT; alu.calculate(); if (alu.result == 1) jump = true; }
-    else if (data.op == "BGT") { alu.op = BGT; alu.calculate(); if (alu.result == 1) jump = true; }
+    if (data.op == Opcode::J) {
+        jump = true;
+    } else {
+        ALU alu;
+        alu.A = registers.read(data.rs);
+        alu.B = registers.read(data.rt);
+        alu.op = isaInfo(data.op).alu;
+        alu.calculate();
+        jump = (alu.result == 1);
+    }
+
+    uint32_t targetAddr = static_cast<uint32_t>(data.imm);
+    uint32_t nextPc = jump ? targetAddr : data.pc + 4;
+    uint32_t predictedPc = data.predictedTaken ? data.predictedTarget : data.pc + 4;
+
+    this->predictor.update(data.pc, jump, targetAddr, data.op == Opcode::J);
+    context.process.branches++;
 
     if (jump) {
-        uint32_t targetAddr = static_cast<uint32_t>(data.immediate);
-        std::cout << "[BRANCH] OP=" << data.op << " tomado. PC Antigo=" << registers.pc.read() << " -> Novo PC=" << targetAddr << "\n";
-        registers.pc.write(targetAddr);
-        
-        if (counter - 1 >= 0 && counter - 1 < this->data.size()) {
-            this->data[counter - 1].op = "BUBBLE";
+        SIM_TRACE(Branch, Debug, "[BRANCH] OP=" << opcodeName(data.op) << " tomado. PC Antigo=" << registers.pc.read() << " -> Novo PC=" << targetAddr << "\n");
+    }
+
+    // Previsão errada: corrige o PC e descarta a instrução buscada no caminho
+    // errado (está no ID neste ciclo)
+    if (nextPc != predictedPc) {
+        registers.pc.write(nextPc);
+        context.process.branch_mispredictions++;
+
+        if (context.counter >= 1 && context.counterForEnd >= 4) {
+            Instruction_Data &wrongPath = this->pipe.at(context.counter - 1);
+            wrongPath.op = Opcode::BUBBLE;
+            wrongPath.predictedTaken = false;
+            context.process.branch_flush_cycles++;
         }
         registers.ir.write(0);
     }
 }
 
 
-
-//Atualizar chamadas para passar o ControlContext
 void Control_Unit::Execute(Instruction_Data &data, ControlContext &context) {
     account_stage(context.process);
-    if (data.op.empty() || data.op == "BUBBLE") return;
-
-    if (data.op == "ADDI" || data.op == "ADDIU" || data.op == "SLTI" || data.op == "LUI" || data.op == "LI") {
-        Execute_Immediate_Operation(context, data); return; 
-    }
-    if (data.op == "ADD" || data.op == "SUB" || data.op == "MULT" || data.op == "DIV") {
-        Execute_Aritmetic_Operation(context, data); return; 
-    } else if (data.op == "BEQ" || data.op == "J" || data.op == "BNE" || data.op == "BGT" || data.op == "BGTI" || data.op == "BLT" || data.op == "BLTI") {
-        Execute_Loop_Operation(context.registers, data, context.counter, context.counterForEnd, context.endProgram, context.memManager, context.process); return;
-    } else if (data.op == "PRINT") {
-        Execute_Operation(data, context); return;
-    }
+    StageHandler handler = EXECUTE_TABLE[static_cast<size_t>(data.op)];
+    if (handler != nullptr) (this->*handler)(data, context);
 }
 
 // Funcao que realiza a etapa de acesso a memoria por meio de diferentes instrucoes
 void Control_Unit::Memory_Acess(Instruction_Data &data, ControlContext &context) {
     account_stage(context.process);
-    if (data.op.empty() || data.op == "BUBBLE") return;
-
-    string name_rt = this->map.getRegisterName(binaryStringToUint(data.target_register));
-
-    // transferencia de uma palavra de 4 bits para o registrador ( string name_rt )
-    if (data.op == "LW") {
-
-        uint32_t addr = binaryStringToUint(data.addressRAMResult);
-        int value = context.memManager.read(addr, context.process);
-        context.registers.writeRegister(name_rt, value);
-        std::cout << "[MEMORY] LW addr=" << addr << " value=" << value << " -> " << name_rt << "\n";
-    
-    // LA e LI carregam um valor imediato para o registrador, sendo o LI podendo ser de 32 ou 16 bits
-    } else if (data.op == "LA" || data.op == "LI") {
-
-        uint32_t val = binaryStringToUint(data.addressRAMResult);
-        context.registers.writeRegister(name_rt, static_cast<int>(val));
-        std::cout << "[MEMORY] " << data.op << " -> " << name_rt << " value=" << static_cast<int>(val) << "\n";
-
-    } else if (data.op == "PRINT" && data.target_register.empty()) {
-
-        uint32_t addr = binaryStringToUint(data.addressRAMResult);
-        int value = context.memManager.read(addr, context.process);
-        auto req = std::make_unique<IORequest>();
-        req->msg = std::to_string(value);
-        req->process = &context.process;
-        context.ioRequests.push_back(std::move(req));
-        std::cout << "[PRINT-REQ] PRINT MEM addr=" << addr << " value=" << value << " (pid=" << context.process.pid << "\n";
+    StageHandler handler = MEMORY_TABLE[static_cast<size_t>(data.op)];
+    if (handler != nullptr) (this->*handler)(data, context);
+}
 
-        if (context.printLock) {
-            context.process.state = State::Blocked;
-            context.endExecution = true;
-        }
+// transferencia de uma palavra de 4 bits para o registrador ( string name_rt )
+void Control_Unit::Memory_Load_Operation(Instruction_Data &data, ControlContext &context) {
+    uint32_t addr = static_cast<uint16_t>(data.imm);
+    int value = context.memManager.read(addr, context.process, this->port, data.pc);
+    if (context.process.pending_page >= 0) return;
+    context.registers.write(data.rt, value);
+    SIM_TRACE(Memory, Debug, "[MEMORY] LW addr=" << addr << " value=" << value << " -> " << hw::REGISTER_BANK::gprName(data.rt) << "\n");
+}
 
-    }
+// LA e LI carregam um valor imediato para o registrador, sendo o LI podendo ser de 32 ou 16 bits
+void Control_Unit::Memory_Immediate_Operation(Instruction_Data &data, ControlContext &context) {
+    uint32_t val = static_cast<uint16_t>(data.imm);
+    context.registers.write(data.rt, val);
+    SIM_TRACE(Memory, Debug, "[MEMORY] " << opcodeName(data.op) << " -> " << hw::REGISTER_BANK::gprName(data.rt) << " value=" << static_cast<int>(val) << "\n");
 }
 
 // Funcao que realiza a etapa de escrita de volta ao banco de registradores ou memoria
 void Control_Unit::Write_Back(Instruction_Data &data, ControlContext &context) {
     account_stage(context.process);
-    if (data.op.empty() || data.op == "BUBBLE") return;
-
-    if (data.op == "SW") {
-        uint32_t addr = binaryStringToUint(data.addressRAMResult);
-        string name_rt = this->map.getRegisterName(binaryStringToUint(data.target_register));
-        int value = context.registers.readRegister(name_rt);
-        context.memManager.write(addr, value, context.process);
-        std::cout << "[WRITE-BACK] SW addr=" << addr << " value=" << value << " from reg " << name_rt << "\n";
-    }
+    StageHandler handler = WRITE_BACK_TABLE[static_cast<size_t>(data.op)];
+    if (handler != nullptr) (this->*handler)(data, context);
+    // O SW que faltou página completa só na retomada
+    if (context.process.pending_page >= 0) return;
+    if (data.op != Opcode::BUBBLE && data.op != Opcode::NOP) context.process.instructions_retired++;
 }
 
-void* Core(MemoryManager &memoryManager, PCB &process, vector<unique_ptr<IORequest>>* ioRequests, bool &printLock) {
-    Control_Unit UC;
-    Instruction_Data data;
+void Control_Unit::Write_Back_Store_Operation(Instruction_Data &data, ControlContext &context) {
+    uint32_t addr = static_cast<uint16_t>(data.imm);
+    int value = context.registers.read(data.rt);
+    context.memManager.write(addr, value, context.process, this->port, data.pc);
+    if (context.process.pending_page >= 0) return;
+    SIM_TRACE(Memory, Debug, "[WRITE-BACK] SW addr=" << addr << " value=" << value << " from reg " << hw::REGISTER_BANK::gprName(data.rt) << "\n");
+}
+
+void Control_Unit::configure(const PipelineConfig &pipelineConfig) {
+    this->config = pipelineConfig;
+    this->predictor = BranchPredictor(pipelineConfig.branchPredictor);
+}
+
+void* Core(Control_Unit &UC, MemoryManager &memoryManager, PCB &process, vector<unique_ptr<IORequest>>* ioRequests, bool &printLock) {
     int clock = 0;
-    int counterForEnd = 5;
-    int counter = 0;
-    bool endProgram = false;
     bool endExecution = false;
 
+    // Retoma as instruções que estavam em voo quando o processo saiu do núcleo
+    if (process.pipeline.inFlight) {
+        UC.pipe = process.pipeline;
+    } else {
+        UC.pipe.clear();
+    }
+    int &counter = UC.pipe.counter;
+    int &counterForEnd = UC.pipe.drainCycles;
+    bool &endProgram = UC.pipe.endProgram;
+
     ControlContext context{ process.regBank, memoryManager, *ioRequests, printLock, process, counter, counterForEnd, endProgram, endExecution };
 
     while (context.counterForEnd > 0) {
-        if (context.counter >= 4 && context.counterForEnd >= 1) {
-            UC.Write_Back(UC.data[context.counter - 4], context);
+        // Depois de uma falta de página o ciclo recomeça no estágio que faltou:
+        // os anteriores na ordem abaixo já executaram antes do bloqueio
+        int resume = UC.pipe.resumeStage;
+        UC.pipe.resumeStage = STAGE_WB;
+        int faulted = -1;
+        auto pageFault = [&](int stage) {
+            if (process.pending_page >= 0) faulted = stage;
+            return faulted >= 0;
+        };
+
+        if (resume >= STAGE_WB && context.counter >= 4 && context.counterForEnd >= 1) {
+            UC.Write_Back(UC.pipe.at(context.counter - 4), context);
+            pageFault(STAGE_WB);
         }
-        if (context.counter >= 3 && context.counterForEnd >= 2) {
-            UC.Memory_Acess(UC.data[context.counter - 3], context);
+        if (faulted < 0 && resume >= STAGE_MEM && context.counter >= 3 && context.counterForEnd >= 2) {
+            UC.Memory_Acess(UC.pipe.at(context.counter - 3), context);
+            pageFault(STAGE_MEM);
         }
-        if (context.counter >= 2 && context.counterForEnd >= 3) {
-            UC.Execute(UC.data[context.counter - 2], context);
+        if (faulted < 0 && resume >= STAGE_EX && context.counter >= 2 && context.counterForEnd >= 3) {
+            UC.Execute(UC.pipe.at(context.counter - 2), context);
         }
-        if (context.counter >= 1 && context.counterForEnd >= 4) {
+        if (faulted < 0 && resume >= STAGE_ID && context.counter >= 1 && context.counterForEnd >= 4) {
             account_stage(process);
-            UC.Decode(context.registers, UC.data[context.counter - 1]);
+            UC.Decode(UC.pipe.at(context.counter - 1), context);
         }
-        if (context.counter >= 0 && context.counterForEnd == 5) {
-            UC.data.push_back(data);
+        if (faulted < 0 && context.counter >= 0 && context.counterForEnd == 5) {
+            UC.pipe.at(context.counter) = Instruction_Data{};
             UC.Fetch(context);
+            // Com o END já decodificado a busca seria descartada: não vale o bloqueio
+            if (pageFault(STAGE_IF) && context.endProgram) {
+                process.pending_page = -1;
+                faulted = -1;
+            }
+        }
+
+        if (faulted >= 0) {
+            // Falta de página à espera do disco: o processo bloqueia com o ciclo
+            // pela metade e o núcleo fica livre para outro (ver MemoryManager::startPageIn)
+            UC.pipe.resumeStage = faulted;
+            UC.pipe.inFlight = true;
+            process.pipeline = UC.pipe;
+            process.state = State::Blocked;
+            return nullptr;
         }
 
         context.counter += 1;
+        UC.pipe.wrap();
         clock += 1;
         account_pipeline_cycle(process);
 
@@ -452,12 +512,23 @@ void* Core(MemoryManager &memoryManager, PCB &process, vector<unique_ptr<IOReque
             context.endExecution = true;
         }
         if (context.endExecution == true) {
+            // Fim do quantum ou bloqueio: congela o pipeline no PCB em vez de esvaziá-lo.
+            // Só o fim do programa esvazia, para completar as instruções em voo.
+            if (!context.endProgram) {
+                UC.pipe.inFlight = true;
+                process.pipeline = UC.pipe;
+                return nullptr;
+            }
             context.counterForEnd -= 1;
         }
     }
 
-    if (context.endProgram) {
-        process.state = State::Finished;
-    }
+    process.pipeline.clear();
+    process.state = State::Finished;
     return nullptr;
-}
\ No newline at end of file
+}
+
+void* Core(MemoryManager &memoryManager, PCB &process, vector<unique_ptr<IORequest>>* ioRequests, bool &printLock) {
+    Control_Unit UC;
+    return Core(UC, memoryManager, process, ioRequests, printLock);
+}
@@ -4,6 +4,10 @@
 #include "REGISTER_BANK.hpp" // Incluído diretamente para ter a definição completa
 #include "ULA.hpp"
 #include "HASH_REGISTER.hpp"
+#include "MicroOp.hpp"
+#include "PipelineState.hpp"
+#include "BranchPredictor.hpp"
+#include "../config/SimConfig.hpp"
 #include "../memory/cache.hpp"
 #include <unordered_map>
 #include <string>
@@ -18,20 +22,16 @@ using std::unique_ptr;
 
 // Forward declarations
 class MemoryManager;
+struct CorePort;
 struct PCB;
 struct IORequest;
 
-void* Core(MemoryManager &memoryManager, PCB &process, vector<unique_ptr<IORequest>>* ioRequests, bool &printLock);
+struct Control_Unit;
 
-struct Instruction_Data {
-    string source_register;
-    string target_register;
-    string destination_register;
-    string op;
-    string addressRAMResult;
-    uint32_t rawInstruction = 0;
-    int32_t immediate = 0;
-};
+// Executa um quantum do processo no pipeline persistente do núcleo
+void* Core(Control_Unit &UC, MemoryManager &memoryManager, PCB &process, vector<unique_ptr<IORequest>>* ioRequests, bool &printLock);
+// Conveniência para quem não mantém um Control_Unit por núcleo (testes)
+void* Core(MemoryManager &memoryManager, PCB &process, vector<unique_ptr<IORequest>>* ioRequests, bool &printLock);
 
 struct ControlContext {
     hw::REGISTER_BANK &registers;
@@ -46,42 +46,44 @@ struct ControlContext {
 };
 
 struct Control_Unit {
-    vector<Instruction_Data> data;
-    hw::Map map;
-
-    std::unordered_map<string, string> instructionMap = {
-        {"add", "000000"}, {"and", "000001"}, {"div", "000010"}, {"mult","000011"},
-        {"sub", "000100"}, {"beq", "000101"}, {"bne", "000110"}, {"bgt", "000111"},
-        {"bgti","001000"}, {"blt", "001001"}, {"blti","001010"}, {"j", "001011"},
-        {"lw", "001100"},  {"sw", "001101"},  {"li", "001110"},  {"la", "001111"},
-        {"print", "010000"},{"end", "111111"}
-    };
-
-    static string Get_immediate(uint32_t instruction);
-    static string Get_destination_Register(uint32_t instruction);
-    static string Get_target_Register(uint32_t instruction);
-    static string Get_source_Register(uint32_t instruction);
+    // Latches do pipeline deste núcleo; trocados com o PCB a cada troca de contexto
+    PipelineState pipe;
+    PipelineConfig config;
+    BranchPredictor predictor;
+    // TLB, L1I e L1D deste núcleo (criados pelo MemoryManager); nullptr = sem TLB nem L1
+    CorePort *port = nullptr;
+
+    // Aplica a configuração do pipeline (forwarding, preditor de desvios)
+    void configure(const PipelineConfig &pipelineConfig);
+
+    static int32_t Get_immediate(uint32_t instruction);
+    static uint8_t Get_destination_Register(uint32_t instruction);
+    static uint8_t Get_target_Register(uint32_t instruction);
+    static uint8_t Get_source_Register(uint32_t instruction);
 
     // Assinatura corrigida para corresponder à implementação
-    string Identificacao_instrucao(uint32_t instruction, hw::REGISTER_BANK &registers);
+    Opcode Identificacao_instrucao(uint32_t instruction, hw::REGISTER_BANK &registers);
+
+    // Decodifica uma palavra em um micro-op (sem consultar o cache)
+    MicroOp Build_MicroOp(uint32_t instruction, hw::REGISTER_BANK &registers);
 
     void Fetch(ControlContext &context);
-    void Decode(hw::REGISTER_BANK &registers, Instruction_Data &data);
-    //Passa o Contexto
-    void Execute_Aritmetic_Operation(ControlContext &context, Instruction_Data &d);
-    void Execute_Operation(Instruction_Data &data, ControlContext &context);
-    void Execute_Loop_Operation(hw::REGISTER_BANK &registers, Instruction_Data &d,
-                        int &counter, int &counterForEnd, bool &endProgram,
-                        MemoryManager &memManager, PCB &process);
+    void Decode(Instruction_Data &data, ControlContext &context);
     void Execute(Instruction_Data &data, ControlContext &context);
-    //Passa o Contexto
-    void Execute_Immediate_Operation(ControlContext &context, Instruction_Data &data);
-
-
-    void log_operation(const std::string &msg, int pid);
-    
     void Memory_Acess(Instruction_Data &data, ControlContext &context);
     void Write_Back(Instruction_Data &data, ControlContext &context);
+
+    // Tratadores de cada unidade, selecionados pelas tabelas de despacho (ISA.hpp)
+    void Execute_Immediate_Operation(Instruction_Data &data, ControlContext &context);
+    void Execute_Aritmetic_Operation(Instruction_Data &data, ControlContext &context);
+    void Execute_Loop_Operation(Instruction_Data &data, ControlContext &context);
+    void Execute_Operation(Instruction_Data &data, ControlContext &context);
+    void Memory_Load_Operation(Instruction_Data &data, ControlContext &context);
+    void Memory_Immediate_Operation(Instruction_Data &data, ControlContext &context);
+    void Write_Back_Store_Operation(Instruction_Data &data, ControlContext &context);
+
+    // Grava a operação de ULA no trace do núcleo
+    void trace_operation(const Instruction_Data &data, ControlContext &context, uint8_t dst, int32_t a, int32_t b, int32_t result);
 };
 
 
@@ -0,0 +1,56 @@
+#include "DecodeCache.hpp"
+
+const MicroOp* DecodeCache::lookup(uint32_t pc) {
+    size_t idx = pc / 4;
+    if ((pc & 3u) == 0 && idx < entries.size() && entries[idx].valid) {
+        hits++;
+        return &entries[idx].uop;
+    }
+    misses++;
+    return nullptr;
+}
+
+void DecodeCache::insert(uint32_t pc, const MicroOp &uop) {
+    size_t idx = pc / 4;
+    if ((pc & 3u) != 0 || idx >= MAX_ENTRIES) return;
+
+    if (idx >= entries.size()) {
+        entries.resize(idx + 1);
+        granuleCount.resize(idx / GRANULE_WORDS + 1, 0);
+    }
+
+    Entry &e = entries[idx];
+    if (!e.valid) granuleCount[idx / GRANULE_WORDS]++;
+    e.uop = uop;
+    e.valid = true;
+}
+
+void DecodeCache::invalidatePage(uint32_t pageBase, size_t pageSize) {
+    size_t first = pageBase / 4;
+    size_t last = (static_cast<size_t>(pageBase) + pageSize) / 4; // exclusivo
+    if (last > entries.size()) last = entries.size();
+
+    for (size_t idx = first; idx < last; ) {
+        size_t g = idx / GRANULE_WORDS;
+        size_t granuleEnd = (g + 1) * GRANULE_WORDS;
+        if (granuleEnd > last) granuleEnd = last;
+
+        // Grânulo sem nenhuma instrução decodificada: pula inteiro
+        if (granuleCount[g] == 0) {
+            idx = granuleEnd;
+            continue;
+        }
+        for (; idx < granuleEnd; ++idx) {
+            if (entries[idx].valid) {
+                entries[idx].valid = false;
+                granuleCount[g]--;
+                invalidations++;
+            }
+        }
+    }
+}
+
+void DecodeCache::clear() {
+    entries.clear();
+    granuleCount.clear();
+}
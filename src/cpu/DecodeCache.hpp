@@ -0,0 +1,48 @@
+#ifndef DECODE_CACHE_HPP
+#define DECODE_CACHE_HPP
+/*
+  DecodeCache.hpp
+  Cache de instruções pré-decodificadas de um processo, indexado pelo PC
+  virtual. Cada PCB possui o seu, então não há disputa entre os núcleos.
+
+  - lookup(): devolve o MicroOp já decodificado para o PC (ou nullptr).
+  - insert(): guarda o resultado do Decode para reuso nas próximas buscas.
+  - invalidatePage(): descarta as entradas de uma página de código; chamado
+    pelo MemoryManager::write quando a página escrita contém instruções
+    decodificadas (código auto-modificável ou carga de um novo programa).
+*/
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "MicroOp.hpp"
+
+class DecodeCache {
+public:
+    // Limite de PCs cacheados (em palavras). Acima disso o Decode é refeito sempre.
+    static constexpr size_t MAX_ENTRIES = 1u << 16;
+    // Granularidade (em palavras) do contador de entradas válidas, usado para
+    // que escritas em páginas sem código não percorram o vetor.
+    static constexpr size_t GRANULE_WORDS = 64;
+
+    const MicroOp* lookup(uint32_t pc);
+    void insert(uint32_t pc, const MicroOp &uop);
+
+    // Descarta as entradas da página [pageBase, pageBase + pageSize).
+    void invalidatePage(uint32_t pageBase, size_t pageSize);
+    void clear();
+
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t invalidations = 0;
+
+private:
+    struct Entry {
+        MicroOp uop;
+        bool valid = false;
+    };
+
+    std::vector<Entry> entries;         // indexado por pc / 4
+    std::vector<uint32_t> granuleCount; // entradas válidas por grânulo
+};
+
+#endif // DECODE_CACHE_HPP
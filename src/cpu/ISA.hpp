@@ -0,0 +1,132 @@
+#ifndef ISA_HPP
+#define ISA_HPP
+/*
+  ISA.hpp
+  Descrição única do conjunto de instruções do simulador.
+
+  Cada linha de ISA_INSTRUCTIONS descreve uma instrução: codificação
+  (opcode primário e funct), formato dos campos, registradores lidos e
+  escrito (para a detecção de hazards), a unidade que a trata em cada estágio
+  do pipeline e a operação da ULA. O enum Opcode, o nome usado nos logs, a
+  tabela de identificação usada pelo Decode e as tabelas de despacho de
+  Execute / Memory_Acess / Write_Back são todos gerados a partir desta lista,
+  então acrescentar uma instrução significa acrescentar uma linha aqui.
+*/
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "ULA.hpp"
+
+// Opcode/funct sem codificação binária (pseudo-instruções internas)
+#define ISA_NO_ENCODING 0xFF
+
+// Formato dos campos extraídos pelo Decode
+enum class InstrFormat : uint8_t {
+    None,   // nenhum campo (END, NOP, ...)
+    R,      // rs, rt, rd
+    I,      // rs, rt, imediato de 16 bits com extensão de sinal
+    J,      // alvo de 26 bits
+    P       // rt e imediato de 16 bits (PRINT)
+};
+
+// Registradores lidos no estágio de execução
+enum InstrReads : uint8_t {
+    READS_NONE  = 0,
+    READS_RS    = 1 << 0,
+    READS_RT    = 1 << 1,
+    READS_RS_RT = READS_RS | READS_RT
+};
+
+// Campo que indica o registrador escrito
+enum class InstrDest : uint8_t { None, RT, RD };
+
+// Unidades de cada estágio
+enum class ExecUnit  : uint8_t { None, Immediate, Arithmetic, Branch, Print };
+enum class MemUnit   : uint8_t { None, Load, LoadImmediate };
+enum class WbUnit    : uint8_t { None, Store };
+
+/*
+  X(nome, opcode, funct, formato, lê, destino, EX, MEM, WB, ULA)
+  Instruções R-type usam opcode 0x00 e são identificadas pelo funct.
+*/
+#define ISA_INSTRUCTIONS(X) \
+    X(NOP,    ISA_NO_ENCODING, ISA_NO_ENCODING, None, READS_NONE,  None, None,       None,          None,  ADD) \
+    X(BUBBLE, ISA_NO_ENCODING, ISA_NO_ENCODING, None, READS_NONE,  None, None,       None,          None,  ADD) \
+    X(ADD,    0x00,            0x20,            R,    READS_RS_RT, RD,   Arithmetic, None,          None,  ADD) \
+    X(SUB,    0x00,            0x22,            R,    READS_RS_RT, RD,   Arithmetic, None,          None,  SUB) \
+    X(MULT,   0x00,            0x18,            R,    READS_RS_RT, RD,   Arithmetic, None,          None,  MUL) \
+    X(DIV,    0x00,            0x1A,            R,    READS_RS_RT, RD,   Arithmetic, None,          None,  DIV) \
+    X(ADDI,   0x08,            ISA_NO_ENCODING, I,    READS_RS,    RT,   Immediate,  None,          None,  ADD) \
+    X(ADDIU,  0x09,            ISA_NO_ENCODING, I,    READS_RS,    RT,   Immediate,  None,          None,  ADD) \
+    X(SLTI,   0x0A,            ISA_NO_ENCODING, I,    READS_RS,    RT,   Immediate,  None,          None,  BLT) \
+    X(LUI,    0x0F,            ISA_NO_ENCODING, I,    READS_NONE,  RT,   Immediate,  None,          None,  ADD) \
+    X(ANDI,   0x0C,            ISA_NO_ENCODING, None, READS_NONE,  None, None,       None,          None,  AND_OP) \
+    X(LI,     0x0E,            ISA_NO_ENCODING, I,    READS_NONE,  RT,   Immediate,  LoadImmediate, None,  ADD) \
+    X(LA,     ISA_NO_ENCODING, ISA_NO_ENCODING, I,    READS_NONE,  RT,   None,       LoadImmediate, None,  LA) \
+    X(LW,     0x23,            ISA_NO_ENCODING, I,    READS_RS,    RT,   None,       Load,          None,  LW) \
+    X(SW,     0x2B,            ISA_NO_ENCODING, I,    READS_RS_RT, None, None,       None,          Store, ST) \
+    X(BEQ,    0x04,            ISA_NO_ENCODING, I,    READS_RS_RT, None, Branch,     None,          None,  BEQ) \
+    X(BNE,    0x05,            ISA_NO_ENCODING, I,    READS_RS_RT, None, Branch,     None,          None,  BNE) \
+    X(BGT,    0x07,            ISA_NO_ENCODING, I,    READS_RS_RT, None, Branch,     None,          None,  BGT) \
+    X(BLT,    0x01,            ISA_NO_ENCODING, I,    READS_RS_RT, None, Branch,     None,          None,  BLT) \
+    X(BGTI,   ISA_NO_ENCODING, ISA_NO_ENCODING, I,    READS_NONE,  None, Branch,     None,          None,  BGTI) \
+    X(BLTI,   ISA_NO_ENCODING, ISA_NO_ENCODING, I,    READS_NONE,  None, Branch,     None,          None,  BLTI) \
+    X(J,      0x02,            ISA_NO_ENCODING, J,    READS_NONE,  None, Branch,     None,          None,  ADD) \
+    X(JAL,    0x03,            ISA_NO_ENCODING, None, READS_NONE,  None, None,       None,          None,  ADD) \
+    X(PRINT,  0x10,            ISA_NO_ENCODING, P,    READS_RT,    None, Print,      None,          None,  ADD) \
+    X(END,    0x3F,            ISA_NO_ENCODING, None, READS_NONE,  None, None,       None,          None,  ADD)
+
+enum class Opcode : uint8_t {
+#define ISA_ENUM_ENTRY(name, opc, funct, fmt, reads, dest, ex, mem, wb, alu) name,
+    ISA_INSTRUCTIONS(ISA_ENUM_ENTRY)
+#undef ISA_ENUM_ENTRY
+};
+
+struct InstrInfo {
+    const char* name;
+    uint8_t opcode;
+    uint8_t funct;
+    InstrFormat format;
+    uint8_t reads;
+    InstrDest dest;
+    ExecUnit ex;
+    MemUnit mem;
+    WbUnit wb;
+    operation alu;
+};
+
+inline constexpr InstrInfo ISA_TABLE[] = {
+#define ISA_TABLE_ENTRY(name, opc, funct, fmt, rd, dst, exu, memu, wbu, aluop) \
+    { #name, opc, funct, InstrFormat::fmt, rd, InstrDest::dst, ExecUnit::exu, MemUnit::memu, WbUnit::wbu, aluop },
+    ISA_INSTRUCTIONS(ISA_TABLE_ENTRY)
+#undef ISA_TABLE_ENTRY
+};
+
+inline constexpr size_t OPCODE_COUNT = sizeof(ISA_TABLE) / sizeof(ISA_TABLE[0]);
+
+inline constexpr const InstrInfo& isaInfo(Opcode op) {
+    return ISA_TABLE[static_cast<size_t>(op)];
+}
+
+// Tabelas de identificação: opcode primário -> Opcode, e funct -> Opcode para R-type
+inline constexpr std::array<Opcode, 64> PRIMARY_OPCODE_TABLE = [] {
+    std::array<Opcode, 64> t{};
+    for (auto &e : t) e = Opcode::NOP;
+    for (size_t i = 0; i < OPCODE_COUNT; ++i) {
+        const InstrInfo &info = ISA_TABLE[i];
+        if (info.opcode != ISA_NO_ENCODING && info.opcode != 0x00) t[info.opcode] = static_cast<Opcode>(i);
+    }
+    return t;
+}();
+
+inline constexpr std::array<Opcode, 64> FUNCT_TABLE = [] {
+    std::array<Opcode, 64> t{};
+    for (auto &e : t) e = Opcode::NOP;
+    for (size_t i = 0; i < OPCODE_COUNT; ++i) {
+        const InstrInfo &info = ISA_TABLE[i];
+        if (info.opcode == 0x00 && info.funct != ISA_NO_ENCODING) t[info.funct] = static_cast<Opcode>(i);
+    }
+    return t;
+}();
+
+#endif // ISA_HPP
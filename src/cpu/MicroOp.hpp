@@ -0,0 +1,28 @@
+#ifndef MICRO_OP_HPP
+#define MICRO_OP_HPP
+/*
+  MicroOp.hpp
+  Representação compacta (POD) de uma instrução já decodificada.
+  O Decode produz um MicroOp uma única vez por PC e os estágios seguintes
+  trabalham apenas com o opcode enumerado, os índices de registradores e o
+  imediato já estendido, sem strings nem conversões binário -> inteiro.
+  O enum Opcode é gerado a partir da descrição da ISA (ISA.hpp).
+*/
+#include <cstdint>
+#include "ISA.hpp"
+
+struct MicroOp {
+    Opcode op = Opcode::NOP;
+    uint8_t rs = 0;         // índice do registrador fonte (0..31)
+    uint8_t rt = 0;         // índice do registrador alvo (0..31)
+    uint8_t rd = 0;         // índice do registrador destino (0..31)
+    int32_t imm = 0;        // imediato com extensão de sinal (ou alvo de 26 bits do J)
+    uint32_t raw = 0;       // palavra original, usada para validar o cache
+};
+
+// Nome textual do opcode, usado apenas em logs (NOP aparece vazio).
+inline const char* opcodeName(Opcode op) {
+    return op == Opcode::NOP ? "" : isaInfo(op).name;
+}
+
+#endif // MICRO_OP_HPP
@@ -9,11 +9,16 @@
 #include <string>
 #include <atomic>
 #include <cstdint>
-#include <unordered_map>
+#include <shared_mutex>
 #include "memory/cache.hpp"
+#include "memory/PageTable.hpp"
 #include "REGISTER_BANK.hpp" // necessidade de objeto completo dentro do PCB
+#include "DecodeCache.hpp"
+#include "PipelineState.hpp"
 
 
+struct SharedImage;   // MemoryManager.hpp
+
 // Estados possíveis do processo (simplificado)
 enum class State {
     Ready,
@@ -43,8 +48,25 @@ struct PCB {
     State state = State::Ready;
     hw::REGISTER_BANK regBank;
 
-    // tabela de páginas, faz o mapeamento Página virtual -> Frame físico
-    std::unordered_map<int, int> pageTable;
+    // tabela de páginas (dois níveis), faz o mapeamento Página virtual -> Frame físico
+    PageTable pageTable;
+    // Lida pelo núcleo que executa o processo; alterada no page fault e quando
+    // outro núcleo escolhe uma página deste processo como vítima do swapOut
+    mutable std::shared_mutex pageTableMutex;
+    // Imagem do programa compartilhada com outros processos (nullptr = páginas próprias)
+    SharedImage* image = nullptr;
+
+    // micro-ops já decodificados deste processo, indexados pelo PC virtual
+    DecodeCache decodeCache;
+
+    // latches do pipeline salvos na troca de contexto (instruções em voo)
+    PipelineState pipeline;
+
+    // Falta de página assíncrona (memory.paging.async): página que o processo
+    // espera do dispositivo de paginação (-1 = nenhuma) e a última que ele
+    // trouxe, cuja nova tentativa de acesso não bloqueia de novo
+    int pending_page = -1;
+    int paged_in = -1;
 
 
 
@@ -59,11 +81,15 @@ struct PCB {
 
     // Contadores de acesso à memória
     std::atomic<uint64_t> primary_mem_accesses{0};
-    std::atomic<uint64_t> secondary_mem_accesses{0};
+    std::atomic<uint64_t> secondary_mem_accesses{0};   // páginas transferidas de/para o disco
+    std::atomic<uint64_t> disk_cycles{0};              // parte de memory_cycles gasta esperando o disco
     std::atomic<uint64_t> memory_cycles{0};
     std::atomic<uint64_t> mem_accesses_total{0};
     std::atomic<uint64_t> extra_cycles{0};
     std::atomic<uint64_t> cache_mem_accesses{0};
+    std::atomic<uint64_t> tlb_hits{0};
+    std::atomic<uint64_t> tlb_misses{0};
+    std::atomic<uint64_t> page_walk_cycles{0};   // parte de memory_cycles gasta percorrendo a tabela de páginas
 
     // Instrumentação detalhada
     std::atomic<uint64_t> pipeline_cycles{0};
@@ -72,13 +98,75 @@ struct PCB {
     std::atomic<uint64_t> mem_writes{0};
 
     // Novos contadores
-    std::atomic<uint64_t> cache_hits{0};
+    std::atomic<uint64_t> cache_hits{0};      // L1D
     std::atomic<uint64_t> cache_misses{0};
+    std::atomic<uint64_t> icache_hits{0};     // L1I (busca de instruções)
+    std::atomic<uint64_t> icache_misses{0};
+    std::atomic<uint64_t> l2_hits{0};
+    std::atomic<uint64_t> l2_misses{0};
+
+    // Coerência (MESI) entre as L1 dos núcleos
+    std::atomic<uint64_t> bus_transactions{0};
+    std::atomic<uint64_t> coherence_invalidations{0};   // cópias de outros núcleos invalidadas
+    std::atomic<uint64_t> cache_to_cache_transfers{0};
+
+    // Prefetch de dados
+    std::atomic<uint64_t> prefetches_issued{0};
+    std::atomic<uint64_t> prefetches_useful{0};    // linha usada antes de sair da L1D
+    std::atomic<uint64_t> prefetches_late{0};      // parte das úteis usada antes de ficar pronta
+    std::atomic<uint64_t> prefetches_useless{0};   // linha que saiu da L1D sem uso
+
+    // Paginação
+    std::atomic<uint64_t> page_faults{0};   // página fora da RAM (nova ou no disco)
+    std::atomic<uint64_t> swap_ins{0};      // páginas do processo trazidas do disco
+    std::atomic<uint64_t> swap_outs{0};     // páginas do processo tiradas da RAM
+    std::atomic<uint64_t> resident_pages{0};        // páginas na RAM agora (RSS)
+    std::atomic<uint64_t> peak_resident_pages{0};
+    std::atomic<uint64_t> resident_pages_sum{0};    // RSS somado a cada acesso (média = soma / acessos)
+    std::atomic<uint64_t> page_fault_blocks{0};     // faltas que bloquearam o processo à espera do disco
+    std::atomic<uint64_t> cow_copies{0};            // páginas da imagem compartilhada copiadas na escrita
     std::atomic<uint64_t> io_cycles{1};
 
+    // Pipeline: instruções completadas, bolhas e adiantamento (forwarding)
+    std::atomic<uint64_t> instructions_retired{0};
+    std::atomic<uint64_t> stall_bubbles{0};    // bolhas inseridas por hazard RAW
+    std::atomic<uint64_t> load_use_stalls{0};  // parte das bolhas que nem o forwarding evita
+    std::atomic<uint64_t> bubbles_avoided{0};  // bolhas que o modo só-stall teria inserido
+    std::atomic<uint64_t> forwards_ex_ex{0};
+    std::atomic<uint64_t> forwards_mem_ex{0};
+
+    // Previsão de desvios
+    std::atomic<uint64_t> branches{0};               // desvios resolvidos no EX
+    std::atomic<uint64_t> branch_mispredictions{0};
+    std::atomic<uint64_t> branch_flush_cycles{0};    // ciclos perdidos com instruções descartadas
+
     MemWeights memWeights;
 };
 
+// Ciclos por instrução completada (0 se nada completou ainda)
+inline double pipeline_cpi(const PCB &pcb) {
+    uint64_t retired = pcb.instructions_retired.load();
+    return retired ? static_cast<double>(pcb.pipeline_cycles.load()) / retired : 0.0;
+}
+
+// Fração de desvios previstos corretamente (1 se não houve desvio)
+inline double branch_accuracy(const PCB &pcb) {
+    uint64_t total = pcb.branches.load();
+    return total ? 1.0 - static_cast<double>(pcb.branch_mispredictions.load()) / total : 1.0;
+}
+
+// Fração das traduções resolvidas pelo TLB (0 se não houve acesso pelo TLB)
+inline double tlb_hit_rate(const PCB &pcb) {
+    uint64_t total = pcb.tlb_hits.load() + pcb.tlb_misses.load();
+    return total ? static_cast<double>(pcb.tlb_hits.load()) / total : 0.0;
+}
+
+// Páginas na RAM em média, medidas a cada acesso traduzido (0 sem acessos)
+inline double mean_resident_pages(const PCB &pcb) {
+    uint64_t total = pcb.mem_accesses_total.load();
+    return total ? static_cast<double>(pcb.resident_pages_sum.load()) / total : 0.0;
+}
+
 // Contabilizar cache
 inline void contabiliza_cache(PCB &pcb, bool hit) {
     if (hit) {
@@ -0,0 +1,63 @@
+#ifndef PIPELINE_STATE_HPP
+#define PIPELINE_STATE_HPP
+/*
+  PipelineState.hpp
+  Latches do pipeline de 5 estágios (IF, ID, EX, MEM, WB).
+
+  A instrução buscada no ciclo c ocupa latches[c % DEPTH] e avança um estágio
+  por ciclo (ID em c+1, EX em c+2, MEM em c+3, WB em c+4), então um anel de 5
+  posições guarda todas as instruções em voo sem alocar nada por ciclo.
+
+  O Control_Unit de cada núcleo trabalha sobre a sua cópia; na troca de
+  contexto (fim do quantum ou bloqueio por IO) o estado é salvo no PCB e
+  restaurado quando o processo volta a executar, sem esvaziar o pipeline.
+  Uma falta de página que bloqueia o processo interrompe o ciclo no meio:
+  resumeStage guarda o estágio que faltou, e a retomada refaz o ciclo dali
+  (os estágios mais adiantados, que rodam antes no ciclo, já executaram).
+  O esvaziamento depois do END (drainCycles, endProgram) também fica aqui:
+  uma falta no MEM ou no WB durante ele não pode fazer a retomada decodificar
+  e buscar de novo.
+*/
+#include <array>
+#include <cstdint>
+#include "MicroOp.hpp"
+
+// Estágios, na ordem em que a instrução passa por eles
+enum PipelineStage : int { STAGE_IF = 0, STAGE_ID, STAGE_EX, STAGE_MEM, STAGE_WB };
+
+// Entrada do pipeline: o micro-op decodificado, o PC de onde foi buscado e a
+// previsão de desvio usada para escolher a próxima busca
+struct Instruction_Data : MicroOp {
+    uint32_t pc = 0;
+    // Previsão feita no Fetch, conferida quando o desvio é resolvido no EX
+    bool predictedTaken = false;
+    uint32_t predictedTarget = 0;
+};
+
+struct PipelineState {
+    static constexpr int DEPTH = 5;
+
+    std::array<Instruction_Data, DEPTH> latches{};
+    int counter = 0;        // ciclos desde que o pipeline começou a encher
+    bool inFlight = false;  // há instruções em voo salvas (processo interrompido)
+    int resumeStage = STAGE_WB; // primeiro estágio a executar no próximo ciclo
+    int drainCycles = DEPTH;    // ciclos que faltam; o END decodificado faz a contagem descer
+    bool endProgram = false;    // END já decodificado: IF e ID não rodam mais
+
+    Instruction_Data& at(int cycle) { return latches[cycle % DEPTH]; }
+
+    // Mantém o contador limitado sem mudar a posição no anel nem o
+    // "pipeline cheio" (counter >= DEPTH - 1) usado pelos estágios
+    void wrap() { if (counter >= 2 * DEPTH) counter -= DEPTH; }
+
+    void clear() {
+        latches = {};
+        counter = 0;
+        inFlight = false;
+        resumeStage = STAGE_WB;
+        drainCycles = DEPTH;
+        endProgram = false;
+    }
+};
+
+#endif // PIPELINE_STATE_HPP
@@ -7,10 +7,10 @@ sendo usados no momento, como o resultado de uma soma ou o endereço da próxima
 instrução.
 
 Na prática, aqui no nosso código, o REGISTER_BANK é uma classe que agrupa todos
-os registradores do MIPS como objetos individuais. A ideia é que, em vez
-de acessar um registrador por um número (como o registrador 16), a Control Unit
-pode simplesmente pedir pelo nome ("s0"), usando os mapas que a gente criou.
-Isso deixa o código do resto do grupo muito mais fácil de ler e entender.
+os registradores do MIPS. Os 32 registradores de uso geral ficam num array
+contíguo acessado por índice (read/write), que é o que a Control Unit usa no
+pipeline, já que o micro-op decodificado traz os índices prontos. O acesso por
+nome ("s0") continua disponível para impressão, testes e código legado.
 
 Este arquivo .hpp é a "interface" da minha parte. Ele só diz o que a classe
 faz e quais funções ela tem. 
@@ -24,8 +24,8 @@ faz e quais funções ela tem.
 #include <cstdint>
 #include <string>
 
+#include <array>
 #include <unordered_map>
-#include <functional>
 
 #include <stdexcept>
 #include <iostream>
@@ -37,27 +37,37 @@ using namespace std;
 // Namespace para o nosso hardware simulado. Serve para evitar que os nomes das nossas classes (como REGISTER_BANK) entrem em conflito com outras bibliotecas.
 namespace hw{
 
-    // Junta todos os registradores da CPU e fornece a interface de acesso por nome que a Control_Unit vai usar.
+    // Junta todos os registradores da CPU. Os de uso geral ficam num vetor contíguo
+    // acessado por índice (caminho usado pela Control_Unit); o acesso por nome é uma
+    // camada de compatibilidade por cima dele.
     class REGISTER_BANK{
     public:
+        static constexpr size_t NUM_GPR = 32;
+
         // --- Registradores de uso específico ---
         REGISTER pc, mar, cr, epc, sr, hi, lo, ir;
 
-        // --- Registradores de uso geral (seguindo a convenção MIPS) ---
-        REGISTER zero, at;
-        REGISTER v0, v1;
-        REGISTER a0, a1, a2, a3;
-        REGISTER t0, t1, t2, t3, t4, t5, t6, t7, t8, t9;
-        REGISTER s0, s1, s2, s3, s4, s5, s6, s7;
-        REGISTER k0, k1;
-        REGISTER gp, sp, fp, ra;
+        // --- Registradores de uso geral ($0..$31, seguindo a convenção MIPS) ---
+        // Contíguos para que salvar/restaurar o contexto seja uma única cópia.
+        std::array<uint32_t, NUM_GPR> gpr{};
+
+        REGISTER_BANK() = default;
+
+        // Leitura por índice (0..31).
+        inline uint32_t read(uint8_t idx) const{
+            return gpr[idx & 0x1Fu];
+        }
 
-        // --- Mapas de acesso por nome (a interface principal para a Control_Unit) ---
-        unordered_map<string, function<uint32_t()>> acessoLeituraRegistradores;
-        unordered_map<string, function<void(uint32_t)>> acessoEscritaRegistradores;
+        // Escrita por índice (0..31). Escritas no $zero são descartadas.
+        inline void write(uint8_t idx, uint32_t value){
+            if ((idx & 0x1Fu) != 0) gpr[idx & 0x1Fu] = value;
+        }
 
-        // Construtor: Declarado aqui, implementado no .cpp
-        REGISTER_BANK();
+        // Nome MIPS do registrador de uso geral (ex: 8 -> "t0").
+        static const char* gprName(uint8_t idx);
+
+        // Índice do registrador de uso geral pelo nome, ou -1 se não for um deles.
+        static int gprIndex(const string &name);
 
         // Leitura segura por nome.
         uint32_t readRegister(const string &name) const;
@@ -77,4 +87,3 @@ namespace hw{
 } 
 
 #endif 
-
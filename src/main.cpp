@@ -8,6 +8,7 @@
 #include <fstream>
 #include "cpu/Scheduler.hpp"
 #include <atomic>
+#include <algorithm>
 #include <mutex>
 #include "nlohmann/json.hpp"
 
@@ -17,6 +18,9 @@
 #include "memory/MemoryManager.hpp"
 #include "parser_json/parser_json.hpp"
 #include "IO/IOManager.hpp"
+#include "config/SimConfig.hpp"
+#include "trace/Console.hpp"
+#include "trace/Trace.hpp"
 
 using json = nlohmann::json;
 namespace fs = std::filesystem;
@@ -39,10 +43,31 @@ void print_metrics(const PCB& pcb) {
     std::cout << "Total de Acessos a Mem: " << pcb.mem_accesses_total.load() << "\n";
     std::cout << "  - Leituras:             " << pcb.mem_reads.load() << "\n";
     std::cout << "  - Escritas:             " << pcb.mem_writes.load() << "\n";
-    std::cout << "Acessos a Cache L1:     " << pcb.cache_mem_accesses.load() << "\n";
+    std::cout << "Acessos a Cache L1D:    " << pcb.cache_mem_accesses.load() << "\n";
     std::cout << "Acessos a Mem Principal:" << pcb.primary_mem_accesses.load() << "\n";
-    std::cout << "Acessos a Mem Secundaria:" << pcb.secondary_mem_accesses.load() << "\n";
+    std::cout << "Acessos a Mem Secundaria:" << pcb.secondary_mem_accesses.load()
+              << " (" << pcb.disk_cycles.load() << " ciclos de disco)\n";
     std::cout << "Ciclos Totais de MemoriA: " << pcb.memory_cycles.load() << "\n";
+    std::cout << "L1D Hits/Miss:          " << pcb.cache_hits.load() << " / " << pcb.cache_misses.load() << "\n";
+    std::cout << "L1I Hits/Miss:          " << pcb.icache_hits.load() << " / " << pcb.icache_misses.load() << "\n";
+    std::cout << "L2 Hits/Miss:           " << pcb.l2_hits.load() << " / " << pcb.l2_misses.load() << "\n";
+    std::cout << "Coerencia (barramento / invalidacoes / cache a cache): " << pcb.bus_transactions.load()
+              << " / " << pcb.coherence_invalidations.load() << " / " << pcb.cache_to_cache_transfers.load() << "\n";
+    std::cout << "Prefetch (emitidos / uteis / atrasados / inuteis): " << pcb.prefetches_issued.load()
+              << " / " << pcb.prefetches_useful.load() << " / " << pcb.prefetches_late.load()
+              << " / " << pcb.prefetches_useless.load() << "\n";
+    std::cout << "Page Faults / Swap In / Swap Out: " << pcb.page_faults.load() << " / " << pcb.swap_ins.load()
+              << " / " << pcb.swap_outs.load() << " (bloqueios: " << pcb.page_fault_blocks.load()
+              << ", copias COW: " << pcb.cow_copies.load() << ")\n";
+    std::cout << "Paginas Residentes (pico / media): " << pcb.peak_resident_pages.load() << " / " << mean_resident_pages(pcb) << "\n";
+    std::cout << "TLB Hits/Miss:          " << pcb.tlb_hits.load() << " / " << pcb.tlb_misses.load()
+              << " (" << tlb_hit_rate(pcb) * 100 << "%, " << pcb.page_walk_cycles.load() << " ciclos de page walk)\n";
+    std::cout << "Decode Cache Hits/Miss: " << pcb.decodeCache.hits << " / " << pcb.decodeCache.misses << "\n";
+    std::cout << "Instrucoes Completadas: " << pcb.instructions_retired.load() << " (CPI " << pipeline_cpi(pcb) << ")\n";
+    std::cout << "Bolhas Inseridas/Evitadas: " << pcb.stall_bubbles.load() << " / " << pcb.bubbles_avoided.load()
+              << " (load-use: " << pcb.load_use_stalls.load() << ")\n";
+    std::cout << "Desvios / Erros Previsao: " << pcb.branches.load() << " / " << pcb.branch_mispredictions.load()
+              << " (acuracia " << branch_accuracy(pcb) * 100 << "%, flush " << pcb.branch_flush_cycles.load() << " ciclos)\n";
     std::cout << "------------------------------------------\n";
 
     fs::create_directories("output/resultados");
@@ -60,6 +85,41 @@ void print_metrics(const PCB& pcb) {
         resultados << "Ciclos de Memória: " << pcb.memory_cycles << "\n";
         resultados << "Cache Hits: " << pcb.cache_hits << "\n";
         resultados << "Cache Misses: " << pcb.cache_misses << "\n";
+        resultados << "L1I Hits: " << pcb.icache_hits << "\n";
+        resultados << "L1I Misses: " << pcb.icache_misses << "\n";
+        resultados << "L2 Hits: " << pcb.l2_hits << "\n";
+        resultados << "L2 Misses: " << pcb.l2_misses << "\n";
+        resultados << "Transações de Barramento: " << pcb.bus_transactions << "\n";
+        resultados << "Invalidações de Coerência: " << pcb.coherence_invalidations << "\n";
+        resultados << "Transferências Cache a Cache: " << pcb.cache_to_cache_transfers << "\n";
+        resultados << "Prefetches Emitidos: " << pcb.prefetches_issued << "\n";
+        resultados << "Prefetches Úteis: " << pcb.prefetches_useful << "\n";
+        resultados << "Prefetches Atrasados: " << pcb.prefetches_late << "\n";
+        resultados << "Prefetches Inúteis: " << pcb.prefetches_useless << "\n";
+        resultados << "Acessos ao Disco: " << pcb.secondary_mem_accesses << "\n";
+        resultados << "Ciclos de Disco: " << pcb.disk_cycles << "\n";
+        resultados << "Page Faults: " << pcb.page_faults << "\n";
+        resultados << "Swap Ins: " << pcb.swap_ins << "\n";
+        resultados << "Swap Outs: " << pcb.swap_outs << "\n";
+        resultados << "Bloqueios por Page Fault: " << pcb.page_fault_blocks << "\n";
+        resultados << "Cópias COW da Imagem: " << pcb.cow_copies << "\n";
+        resultados << "Pico de Páginas Residentes: " << pcb.peak_resident_pages << "\n";
+        resultados << "Média de Páginas Residentes: " << mean_resident_pages(pcb) << "\n";
+        resultados << "TLB Hits: " << pcb.tlb_hits << "\n";
+        resultados << "TLB Misses: " << pcb.tlb_misses << "\n";
+        resultados << "Ciclos de Page Walk: " << pcb.page_walk_cycles << "\n";
+        resultados << "Decode Cache Hits: " << pcb.decodeCache.hits << "\n";
+        resultados << "Decode Cache Misses: " << pcb.decodeCache.misses << "\n";
+        resultados << "Instruções Completadas: " << pcb.instructions_retired << "\n";
+        resultados << "CPI: " << pipeline_cpi(pcb) << "\n";
+        resultados << "Bolhas Inseridas: " << pcb.stall_bubbles << "\n";
+        resultados << "Bolhas de Load-Use: " << pcb.load_use_stalls << "\n";
+        resultados << "Bolhas Evitadas (forwarding): " << pcb.bubbles_avoided << "\n";
+        resultados << "Forwarding EX->EX / MEM->EX: " << pcb.forwards_ex_ex << " / " << pcb.forwards_mem_ex << "\n";
+        resultados << "Desvios Resolvidos: " << pcb.branches << "\n";
+        resultados << "Previsões Erradas: " << pcb.branch_mispredictions << "\n";
+        resultados << "Acurácia da Previsão: " << branch_accuracy(pcb) * 100 << "%\n";
+        resultados << "Ciclos de Flush: " << pcb.branch_flush_cycles << "\n";
         resultados << "--------------------------------\n";
     }
 
@@ -67,17 +127,38 @@ void print_metrics(const PCB& pcb) {
         output << "=== Saída Lógica do Programa ===\n";
         output << "Registradores principais:\n";
         output << pcb.regBank.get_registers_as_string() << "\n";
-        output << "\n=== Operações Executadas ===\n";
+    }
+}
 
-        std::string temp_filename = "output/trace_logs/temp_" + std::to_string(pcb.pid) + ".log";
-        
-        if (fs::exists(temp_filename)) { 
-            std::ifstream temp_file(temp_filename);
-            if (temp_file.is_open()) {
-                output << temp_file.rdbuf();
-                temp_file.close();
-            }
-        } else {
+// Acrescenta a cada output_<pid>.dat as operações registradas no trace da execução
+void append_trace_sections(const std::vector<std::unique_ptr<PCB>> &process_list, const std::string &tracePath)
+{
+    std::vector<trace::Record> records;
+    bool loaded = trace::load(tracePath, records);
+
+    // Um processo migra entre núcleos, então os registros dele vêm de anéis diferentes;
+    // o ciclo do processo restaura a ordem de execução
+    std::stable_sort(records.begin(), records.end(), [](const trace::Record &x, const trace::Record &y) {
+        return x.pid != y.pid ? x.pid < y.pid : x.cycle < y.cycle;
+    });
+
+    for (const auto &ptr : process_list) {
+        const PCB &pcb = *ptr;
+        std::string filename = "output/resultados/output_" + std::to_string(pcb.pid) + ".dat";
+        if (!fs::exists(filename)) continue; // processo não terminou: não há saída
+
+        std::ofstream output(filename, std::ios::app);
+        if (!output.is_open()) continue;
+
+        output << "\n=== Operações Executadas ===\n";
+        auto first = std::lower_bound(records.begin(), records.end(), pcb.pid,
+                                      [](const trace::Record &r, int pid) { return r.pid < pid; });
+        bool any = false;
+        for (auto it = first; it != records.end() && it->pid == pcb.pid; ++it) {
+            output << trace::render_record(*it) << "\n";
+            any = true;
+        }
+        if (!loaded || !any) {
             output << "(Nenhuma operação registrada ou falha de log na UC)\n";
         }
         output << "\n=== Fim das Operações Registradas ===\n";
@@ -92,6 +173,11 @@ void print_system_metrics(const std::vector<std::unique_ptr<PCB>> &process_list,
     uint64_t total_turnaround = 0;
     uint64_t total_cpu_time = 0;
     uint64_t max_finish_time = 0;
+    uint64_t total_branches = 0;
+    uint64_t total_mispredictions = 0;
+    uint64_t total_flush_cycles = 0;
+    uint64_t l1d_hits = 0, l1d_misses = 0, l1i_hits = 0, l1i_misses = 0;
+    uint64_t page_faults = 0, swap_ins = 0, swap_outs = 0, mem_accesses = 0, fault_blocks = 0;
 
     int process_count = process_list.size();
 
@@ -109,6 +195,18 @@ void print_system_metrics(const std::vector<std::unique_ptr<PCB>> &process_list,
         total_waiting   += derived_wait; // Usamos o valor corrigido
         total_turnaround+= turnaround;
         total_cpu_time  += p->cpu_time;
+        total_branches       += p->branches;
+        total_mispredictions += p->branch_mispredictions;
+        total_flush_cycles   += p->branch_flush_cycles;
+        l1d_hits   += p->cache_hits;
+        l1d_misses += p->cache_misses;
+        l1i_hits   += p->icache_hits;
+        l1i_misses += p->icache_misses;
+        page_faults  += p->page_faults;
+        swap_ins     += p->swap_ins;
+        swap_outs    += p->swap_outs;
+        fault_blocks += p->page_fault_blocks;
+        mem_accesses += p->mem_accesses_total;
 
         if (p->finish_time > max_finish_time)
             max_finish_time = p->finish_time;
@@ -139,6 +237,10 @@ void print_system_metrics(const std::vector<std::unique_ptr<PCB>> &process_list,
     double throughput     = (max_finish_time > 0) ? (double) process_count    / max_finish_time : 0;
     double ideal_time     = (double) total_cpu_time   / NUM_CORES;
     double efficiency     = (max_finish_time > 0) ? ideal_time / max_finish_time : 0;
+    double branch_acc     = (total_branches > 0) ? 1.0 - (double) total_mispredictions / total_branches : 1.0;
+    double l1d_miss_rate  = (l1d_hits + l1d_misses > 0) ? (double) l1d_misses / (l1d_hits + l1d_misses) : 0;
+    double l1i_miss_rate  = (l1i_hits + l1i_misses > 0) ? (double) l1i_misses / (l1i_hits + l1i_misses) : 0;
+    double fault_rate     = (mem_accesses > 0) ? (double) page_faults / mem_accesses : 0;
 
     // Prints no Console
     std::cout << "\n======================================\n";
@@ -150,6 +252,13 @@ void print_system_metrics(const std::vector<std::unique_ptr<PCB>> &process_list,
     std::cout << "Utilização média da CPU:  " << cpu_util * 100 << "%\n";
     std::cout << "Throughput global:        " << throughput << "\n";
     std::cout << "Eficiência:               " << efficiency * 100 << "%\n";
+    std::cout << "Acurácia prev. desvios:   " << branch_acc * 100 << "% (" << total_mispredictions << "/" << total_branches << " erros)\n";
+    std::cout << "Ciclos de flush:          " << total_flush_cycles << "\n";
+    std::cout << "Miss L1D:                 " << l1d_miss_rate * 100 << "% (" << l1d_misses << "/" << l1d_hits + l1d_misses << ")\n";
+    std::cout << "Miss L1I:                 " << l1i_miss_rate * 100 << "% (" << l1i_misses << "/" << l1i_hits + l1i_misses << ")\n";
+    std::cout << "Page faults:              " << fault_rate * 100 << "% (" << page_faults << "/" << mem_accesses << " acessos)\n";
+    std::cout << "Swap in / Swap out:       " << swap_ins << " / " << swap_outs << "\n";
+    std::cout << "Bloqueios por page fault: " << fault_blocks << "\n";
     std::cout << "======================================\n\n";
     
     // Escrita no Arquivo
@@ -165,7 +274,14 @@ void print_system_metrics(const std::vector<std::unique_ptr<PCB>> &process_list,
     file << "==== MÉTRICAS DA POLÍTICA " << policyName << " ====\n\n";
     file << "Tempo total simulação:    " << max_finish_time << "\n";
     file << "Utilização média da CPU:  " << cpu_util * 100 << "%\n";
-    file << "Throughput global:        " << throughput << "\n\n";
+    file << "Throughput global:        " << throughput << "\n";
+    file << "Acurácia prev. desvios:   " << branch_acc * 100 << "%\n";
+    file << "Ciclos de flush:          " << total_flush_cycles << "\n";
+    file << "Miss L1D:                 " << l1d_miss_rate * 100 << "%\n";
+    file << "Miss L1I:                 " << l1i_miss_rate * 100 << "%\n";
+    file << "Page faults:              " << fault_rate * 100 << "% (" << page_faults << ")\n";
+    file << "Swap in / Swap out:       " << swap_ins << " / " << swap_outs << "\n";
+    file << "Bloqueios por page fault: " << fault_blocks << "\n\n";
     
     file << "---- Métricas por processo ----\n";
     for (const auto &ptr : process_list) {
@@ -189,7 +305,7 @@ void ioWorker(Scheduler &scheduler, std::vector<PCB*> &blocked_list,
               std::mutex &blocked_mutex, std::atomic<int> &finished_processes, 
               const int total_processes) 
 {
-    std::cout << "[IOM] Thread de IO Iniciada.\n";
+    SIM_TRACE(Io, Info, "[IOM] Thread de IO Iniciada.\n");
     while (finished_processes.load() < total_processes) {
         std::this_thread::sleep_for(std::chrono::milliseconds(5));
         std::lock_guard<std::mutex> lock(blocked_mutex);
@@ -207,10 +323,14 @@ void ioWorker(Scheduler &scheduler, std::vector<PCB*> &blocked_list,
 
 void coreWorker(int coreId, Scheduler& scheduler, MemoryManager& memManager, IOManager& ioManager, 
                 std::vector<PCB*>& blocked_list, std::mutex& blocked_mutex, 
-                std::atomic<int>& finished_processes, int total_processes)
+                std::atomic<int>& finished_processes, int total_processes, const SimConfig& config)
 {
     bool print_lock = true;
     std::vector<std::unique_ptr<IORequest>> io_requests;
+    // Pipeline deste núcleo, reaproveitado entre quanta (o estado em voo vai para o PCB)
+    Control_Unit UC;
+    UC.configure(config.pipeline);
+    UC.port = memManager.attachCore();
 
     while (finished_processes.load() < total_processes || scheduler.hasProcesses()) {
     
@@ -222,14 +342,14 @@ void coreWorker(int coreId, Scheduler& scheduler, MemoryManager& memManager, IOM
             continue;
         }
 
-        std::cout << "\n[Core " << coreId << "] Executando PID " << current_process->pid << "\n";
+        SIM_TRACE(Scheduler, Info, "\n[Core " << coreId << "] Executando PID " << current_process->pid << "\n");
 
         current_process->state = State::Running;
         io_requests.clear();
 
         // Medição de ciclos
         uint64_t before = current_process->pipeline_cycles.load();
-        Core(memManager, *current_process, &io_requests, print_lock);
+        Core(UC, memManager, *current_process, &io_requests, print_lock);
         uint64_t after = current_process->pipeline_cycles.load();
         
         uint64_t used = (after > before ? after - before : 0);
@@ -242,21 +362,25 @@ void coreWorker(int coreId, Scheduler& scheduler, MemoryManager& memManager, IOM
 
         switch (current_process->state) {
             case State::Blocked:
-                ioManager.registerProcessWaitingForIO(current_process);
+                // Falta de página: quem acorda o processo é o dispositivo de paginação
+                if (current_process->pending_page < 0) ioManager.registerProcessWaitingForIO(current_process);
                 {
                     std::lock_guard<std::mutex> lock(blocked_mutex);
                     blocked_list.push_back(current_process);
                 }
+                if (current_process->pending_page >= 0) memManager.startPageIn(*current_process);
                 break;
 
             case State::Finished:
                 // Salva o tempo de término baseado no relógio deste core
                 current_process->finish_time = g_core_clock[coreId].load();
                 
-                std::cout << "[Core " << coreId << "] PID " << current_process->pid 
-                          << " FINALIZADO em T=" << current_process->finish_time << "\n";
+                SIM_TRACE(Scheduler, Info, "[Core " << coreId << "] PID " << current_process->pid
+                          << " FINALIZADO em T=" << current_process->finish_time << "\n");
                           
                 print_metrics(*current_process);
+                // Os registradores já foram salvos: frames e disco voltam para os outros processos
+                memManager.releaseProcess(*current_process);
                 finished_processes.fetch_add(1);
                 break;
 
@@ -274,6 +398,22 @@ void coreWorker(int coreId, Scheduler& scheduler, MemoryManager& memManager, IOM
     }
 }
 
+// Frames ocupados ao longo da execução (série limitada; cada ponto é o maior valor do intervalo)
+void write_resident_history(const std::vector<std::pair<uint64_t, size_t>> &history, const std::string &policyName)
+{
+    fs::create_directories("output/metricas");
+    std::ofstream file("output/metricas/rss_" + policyName + ".dat");
+    if (!file.is_open()) return;
+
+    size_t peak = 0;
+    file << "# acesso frames_ocupados\n";
+    for (const auto &[access, frames] : history) {
+        file << access << " " << frames << "\n";
+        peak = std::max(peak, frames);
+    }
+    std::cout << "Frames ocupados (pico):   " << peak << "\n";
+}
+
 void run_simulation_with_policy(SchedulingPolicy policy, const std::string &policyName)
 {
     std::cout << "=== Inicializando o Simulador (" << policyName << ") - Fase 1: Limpeza ===\n";
@@ -301,8 +441,12 @@ void run_simulation_with_policy(SchedulingPolicy policy, const std::string &poli
         g_core_busy[i].store(0);
     }
 
-    // Defina o tamanho da memória aqui (ex: 320, 512, 1024)
-    MemoryManager memManager(512, 8192); 
+    SimConfig config;
+    load_sim_config("batch.json", config);
+    trace::set_console_levels(config.trace.console);
+
+    // Tamanho da RAM em memory.main_memory_bytes do batch.json (512 por padrão)
+    MemoryManager memManager(config.memory.mainMemoryBytes, 8192, config.memory);
     IOManager ioManager;
     Scheduler scheduler(policy, SYSTEM_QUANTUM);
     std::vector<std::unique_ptr<PCB>> process_list;
@@ -338,17 +482,24 @@ void run_simulation_with_policy(SchedulingPolicy policy, const std::string &poli
     std::vector<std::thread> core_threads;
     core_threads.reserve(NUM_CORES);
 
+    const std::string tracePath = "output/trace_logs/trace.bin";
+    trace::Tracer::instance().start(tracePath);
+
     std::thread io_thread(ioWorker, std::ref(scheduler), std::ref(blocked_list), std::ref(blocked_mutex), std::ref(finished_processes), total_processes);
 
     for (int i = 0; i < NUM_CORES; ++i) {
-        core_threads.emplace_back(coreWorker, i, std::ref(scheduler), std::ref(memManager), std::ref(ioManager), std::ref(blocked_list), std::ref(blocked_mutex), std::ref(finished_processes), total_processes);
+        core_threads.emplace_back(coreWorker, i, std::ref(scheduler), std::ref(memManager), std::ref(ioManager), std::ref(blocked_list), std::ref(blocked_mutex), std::ref(finished_processes), total_processes, std::cref(config));
     }
 
     for (auto &t : core_threads) if (t.joinable()) t.join();
     if (io_thread.joinable()) io_thread.join();
 
+    trace::Tracer::instance().stop();
+    append_trace_sections(process_list, tracePath);
+
     std::cout << "\n=== Simulador Encerrado ===\n";
     print_system_metrics(process_list, policyName);
+    write_resident_history(memManager.residentHistory(), policyName);
 }
 
 int main() {
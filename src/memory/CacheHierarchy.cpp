@@ -0,0 +1,291 @@
+#include "CacheHierarchy.hpp"
+#include <vector>
+#include "MemoryManager.hpp"
+#include "../cpu/PCB.hpp"
+#include "../trace/Console.hpp"
+
+// Todos os níveis usam o tamanho de linha da L1D: uma linha de L1 é sempre uma linha de L2
+static CacheConfig withLineSize(CacheConfig config, unsigned lineSize) {
+    config.lineSize = lineSize;
+    return config;
+}
+
+CacheHierarchy::CacheHierarchy(const CacheConfig &l1dConfig, const CacheConfig &l1iConfig, const CacheConfig &l2Config,
+                               const CoherenceConfig &coherence, MemoryManager *memory)
+    : l1dCfg(l1dConfig), l1iCfg(withLineSize(l1iConfig, l1dConfig.lineSize)), coherence(coherence),
+      memory(memory), l2(withLineSize(l2Config, l1dConfig.lineSize)) {}
+
+CacheHierarchy::CoreCaches CacheHierarchy::addCore() {
+    std::lock_guard<std::mutex> bus(busMutex);
+    l1s.push_back(std::make_unique<Cache>(l1iCfg));
+    Cache *l1i = l1s.back().get();
+    l1s.push_back(std::make_unique<Cache>(l1dCfg));
+    return {l1i, l1s.back().get()};
+}
+
+uint32_t CacheHierarchy::read(Cache *l1d, size_t address, PCB &process) {
+    return load(l1d, address, process, false);
+}
+
+uint32_t CacheHierarchy::fetch(Cache *l1i, size_t address, PCB &process) {
+    return load(l1i, address, process, true);
+}
+
+uint32_t CacheHierarchy::load(Cache *l1, size_t address, PCB &process, bool instruction) {
+    if (l1 != nullptr) {
+        auto setLock = l1->lockSet(address);
+        bool hit = l1->lookup(address);
+        if (instruction) {
+            (hit ? process.icache_hits : process.icache_misses).fetch_add(1);
+        } else {
+            process.cache_mem_accesses.fetch_add(1);
+            contabiliza_cache(process, hit);
+        }
+        if (hit) {
+            process.memory_cycles.fetch_add(l1HitCost(*l1, process));
+            usePrefetched(*l1, address, process);
+            return l1->readWord(address);
+        }
+    }
+
+    // Miss: BusRd
+    std::lock_guard<std::mutex> bus(busMutex);
+    size_t line = l2.lineBase(address);
+    std::vector<uint32_t> words(l2.wordsInLine());
+    bool shared = false;
+    process.memory_cycles.fetch_add(busRead(l1, line, words.data(), shared, process));
+
+    uint32_t value = words[(address - line) / 4];
+    if (l1 == nullptr) return value;
+
+    // A L1I nunca fica com a linha exclusiva: a escrita seguinte tem de passar pelo barramento
+    auto setLock = l1->lockSet(line);
+    EvictedLine evicted;
+    LineState state = (shared || instruction) ? LineState::Shared : LineState::Exclusive;
+    if (l1->install(line, words.data(), state, evicted)) {
+        retireFromL1(evicted, process);
+    }
+    return value;
+}
+
+bool CacheHierarchy::prefetch(Cache *l1d, size_t address, PCB &process) {
+    size_t line = l2.lineBase(address);
+    {
+        auto setLock = l1d->lockSet(line);
+        if (l1d->state(line) != LineState::Invalid) return false;
+    }
+
+    std::lock_guard<std::mutex> bus(busMutex);
+    std::vector<uint32_t> words(l2.wordsInLine());
+    bool shared = false;
+    // Fora do caminho crítico: o custo não é cobrado, só atrasa o momento em que a linha fica pronta
+    uint64_t latency = busRead(l1d, line, words.data(), shared, process);
+
+    auto setLock = l1d->lockSet(line);
+    EvictedLine evicted;
+    if (l1d->install(line, words.data(), shared ? LineState::Shared : LineState::Exclusive, evicted)) {
+        retireFromL1(evicted, process);
+    }
+    l1d->markPrefetched(line, processClock(process) + latency);
+    process.prefetches_issued.fetch_add(1);
+    return true;
+}
+
+void CacheHierarchy::usePrefetched(Cache &l1, size_t address, PCB &process) {
+    uint64_t readyAt;
+    if (!l1.consumePrefetch(address, readyAt)) return;
+    process.prefetches_useful.fetch_add(1);
+    uint64_t now = processClock(process);
+    if (readyAt > now) {
+        // Prefetch atrasado: o acesso espera o resto do preenchimento
+        process.prefetches_late.fetch_add(1);
+        process.memory_cycles.fetch_add(readyAt - now);
+    }
+}
+
+uint64_t CacheHierarchy::processClock(const PCB &process) {
+    return process.pipeline_cycles.load() + process.memory_cycles.load();
+}
+
+uint64_t CacheHierarchy::busRead(const Cache *requester, size_t line, uint32_t *words, bool &shared, PCB &process) {
+    process.bus_transactions.fetch_add(1);
+    uint64_t cost = coherence.busLatency;
+
+    bool supplied = false;
+    for (auto &other : l1s) {
+        if (other.get() == requester) continue;
+        auto setLock = other->lockSet(line);
+        LineState state = other->state(line);
+        if (state == LineState::Invalid) continue;
+        shared = true;
+        if (state == LineState::Shared) continue;
+
+        // Modified ou Exclusive: a linha vem desta L1 e as duas cópias ficam Shared
+        other->readLine(line, words);
+        if (state == LineState::Modified) {
+            l2.writeLine(line, words);
+            l2.setState(line, LineState::Modified);
+        }
+        other->setState(line, LineState::Shared);
+        supplied = true;
+        process.cache_to_cache_transfers.fetch_add(1);
+        cost += coherence.transferLatency;
+        SIM_TRACE(Memory, Debug, "[MESI] BusRd linha " << line << ": transferencia cache a cache\n");
+    }
+    if (!supplied) cost += fetchFromL2(line, words, process);
+    return cost;
+}
+
+void CacheHierarchy::write(Cache *l1, size_t address, uint32_t value, PCB &process) {
+    if (l1 != nullptr) {
+        auto setLock = l1->lockSet(address);
+        process.cache_mem_accesses.fetch_add(1);
+        bool hit = l1->lookup(address);
+        contabiliza_cache(process, hit);
+        process.memory_cycles.fetch_add(l1HitCost(*l1, process));
+        if (hit) usePrefetched(*l1, address, process);
+        LineState state = l1->state(address);
+        if (state == LineState::Modified || state == LineState::Exclusive) {
+            l1->writeWord(address, value);
+            return;
+        }
+    }
+
+    // Linha ausente (BusRdX) ou compartilhada (BusUpgr): os outros perdem a cópia
+    std::lock_guard<std::mutex> bus(busMutex);
+    size_t line = l2.lineBase(address);
+    std::vector<uint32_t> words(l2.wordsInLine());
+    process.bus_transactions.fetch_add(1);
+    process.memory_cycles.fetch_add(coherence.busLatency);
+
+    // Um snoop pode ter invalidado a linha entre o acerto e o barramento
+    LineState own = LineState::Invalid;
+    if (l1 != nullptr) {
+        auto setLock = l1->lockSet(line);
+        own = l1->state(line);
+    }
+
+    bool supplied = false;
+    for (auto &other : l1s) {
+        if (other.get() == l1) continue;
+        auto setLock = other->lockSet(line);
+        LineState state = other->state(line);
+        if (state == LineState::Invalid) continue;
+
+        if (state == LineState::Modified || (state == LineState::Exclusive && own == LineState::Invalid)) {
+            other->readLine(line, words.data());
+            supplied = true;
+            process.cache_to_cache_transfers.fetch_add(1);
+            process.memory_cycles.fetch_add(coherence.transferLatency);
+        }
+        other->invalidate(line);
+        process.coherence_invalidations.fetch_add(1);
+        process.memory_cycles.fetch_add(coherence.invalidateLatency);
+        SIM_TRACE(Memory, Debug, "[MESI] " << (own == LineState::Shared ? "BusUpgr" : "BusRdX")
+                  << " linha " << line << ": copia invalidada\n");
+    }
+
+    if (l1 == nullptr) {
+        // Sem L1: a escrita fica na L2, com o conteúdo mais recente da linha
+        if (l2.state(line) == LineState::Invalid) {
+            if (supplied) {
+                EvictedLine evicted;
+                if (l2.install(line, words.data(), LineState::Modified, evicted)) retireFromL2(evicted);
+            } else {
+                process.memory_cycles.fetch_add(fetchFromL2(line, words.data(), process));
+            }
+        } else if (supplied) {
+            l2.writeLine(line, words.data());
+        }
+        l2.writeWord(address, value);
+        return;
+    }
+
+    // A busca na L2 pode invalidar linhas desta L1 (inclusão): antes da trava do conjunto
+    if (own == LineState::Invalid && !supplied) {
+        process.memory_cycles.fetch_add(fetchFromL2(line, words.data(), process));
+    }
+    auto setLock = l1->lockSet(line);
+    if (own == LineState::Invalid) {
+        EvictedLine evicted;
+        if (l1->install(line, words.data(), LineState::Modified, evicted)) retireFromL1(evicted, process);
+    }
+    l1->writeWord(address, value);
+}
+
+uint64_t CacheHierarchy::fetchFromL2(size_t line, uint32_t *words, PCB &process) {
+    if (l2.lookup(line)) {
+        process.l2_hits.fetch_add(1);
+        l2.readLine(line, words);
+        return l2HitCost(process);
+    }
+
+    process.l2_misses.fetch_add(1);
+    process.primary_mem_accesses.fetch_add(1);
+    for (size_t i = 0; i < l2.wordsInLine(); ++i) {
+        words[i] = memory->readFromFile(static_cast<uint32_t>(line + i * 4));
+    }
+    EvictedLine evicted;
+    if (l2.install(line, words, LineState::Shared, evicted)) retireFromL2(evicted);
+    return memoryCost(process);
+}
+
+void CacheHierarchy::retireFromL1(const EvictedLine &evicted, PCB &process) {
+    if (evicted.prefetched) process.prefetches_useless.fetch_add(1);
+    if (evicted.state != LineState::Modified) return;
+    if (l2.state(evicted.address) != LineState::Invalid) {
+        l2.writeLine(evicted.address, evicted.words.data());
+        l2.setState(evicted.address, LineState::Modified);
+    } else {
+        writeLineToMemory(evicted.address, evicted.words.data());
+    }
+}
+
+void CacheHierarchy::retireFromL2(EvictedLine &evicted) {
+    bool dirty = evicted.state == LineState::Modified;
+    for (auto &l1 : l1s) {
+        auto setLock = l1->lockSet(evicted.address);
+        LineState state = l1->state(evicted.address);
+        if (state == LineState::Modified) {
+            l1->readLine(evicted.address, evicted.words.data());
+            dirty = true;
+        }
+        l1->invalidate(evicted.address);
+    }
+    if (dirty) writeLineToMemory(evicted.address, evicted.words.data());
+}
+
+void CacheHierarchy::writeLineToMemory(size_t line, const uint32_t *words) {
+    for (size_t i = 0; i < l2.wordsInLine(); ++i) {
+        memory->writeToFile(static_cast<uint32_t>(line + i * 4), words[i]);
+    }
+}
+
+void CacheHierarchy::flushRange(size_t base, size_t size) {
+    std::lock_guard<std::mutex> bus(busMutex);
+    for (size_t line = l2.lineBase(base); line < base + size; line += l2.lineSize()) {
+        EvictedLine evicted;
+        evicted.address = line;
+        evicted.state = l2.state(line);
+        if (evicted.state == LineState::Invalid) continue;   // inclusiva: nenhuma L1 tem a linha
+        evicted.words.resize(l2.wordsInLine());
+        l2.readLine(line, evicted.words.data());
+        l2.invalidate(line);
+        retireFromL2(evicted);
+    }
+}
+
+uint64_t CacheHierarchy::l1HitCost(const Cache &l1, const PCB &process) const {
+    unsigned latency = l1.config().hitLatency;
+    return latency ? latency : process.memWeights.cache;
+}
+
+uint64_t CacheHierarchy::l2HitCost(const PCB &process) const {
+    unsigned latency = l2.config().hitLatency;
+    return latency ? latency : (process.memWeights.cache + process.memWeights.primary) / 2;
+}
+
+uint64_t CacheHierarchy::memoryCost(const PCB &process) const {
+    unsigned latency = l2.config().missLatency;
+    return latency ? latency : process.memWeights.primary;
+}
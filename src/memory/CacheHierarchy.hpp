@@ -0,0 +1,117 @@
+#ifndef CACHE_HIERARCHY_HPP
+#define CACHE_HIERARCHY_HPP
+/*
+  CacheHierarchy.hpp
+  Caches do sistema: cada núcleo tem uma L1 de dados (L1D, LW/SW) e uma de
+  instruções (L1I, só a busca), e todos compartilham uma L2 inclusiva (toda
+  linha de uma L1 também está na L2), na frente da RAM. As três têm
+  geometria própria, mas o mesmo tamanho de linha (o da L1D).
+
+  As L1 são mantidas coerentes por snooping com o protocolo MESI:
+  - leitura com miss (BusRd): quem tem a linha Modified ou Exclusive a
+    entrega direto (transferência cache a cache) e passa para Shared; o
+    Modified ainda a escreve de volta na L2. Sem ninguém, a linha vem da L2
+    (ou da RAM) e entra Exclusive; com outra cópia, entra Shared.
+  - escrita com miss (BusRdX) ou em linha Shared (BusUpgr): as cópias dos
+    outros núcleos são invalidadas e a linha fica Modified.
+  - escrita em Exclusive ou Modified e leitura com acerto não usam o barramento.
+  A L1I só lê: as linhas dela entram sempre Shared e nunca são escritas de
+  volta. Ela participa do snooping como as outras, então uma escrita em
+  página de código (inclusive do próprio núcleo) invalida a linha na L1I.
+  As L1 e a L2 são write-back: linha Modified que sai da L1 vai para a L2,
+  linha suja que sai da L2 vai para a RAM. Tirar uma linha da L2 invalida
+  as cópias dela nas L1 (inclusão).
+
+  Custos (somados a memory_cycles do processo; 0 na configuração = pesos do PCB):
+  acerto na L1 = l1d/l1i.hit_latency (peso cache); toda transação de barramento
+  = coherence.bus_latency, mais a fonte da linha: outra L1 =
+  transfer_latency, L2 = l2.hit_latency ((cache + primary) / 2),
+  RAM = l2.miss_latency (peso primary); cada cópia invalidada = invalidate_latency.
+
+  Travas: o barramento (busMutex) serializa as transações, como um barramento
+  de snooping real. Um acerto na L1 só trava o conjunto dela; quem tem o
+  barramento trava os conjuntos das L1 um de cada vez (nunca dois juntos), e
+  a L2 só é usada com o barramento.
+
+  Acessos sem L1 (nullptr: carga de programas, testes) vão direto à L2,
+  participando da coerência como um núcleo sem cache.
+
+  Prefetch (Prefetcher.hpp): a linha pedida entra na L1D pelo mesmo BusRd,
+  marcada com o ciclo em que fica pronta. O primeiro acesso de demanda a ela
+  conta como prefetch útil (e atrasado, se chegar antes desse ciclo); se ela
+  sair da L1D sem uso, o prefetch foi inútil.
+*/
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "cache.hpp"
+#include "../config/SimConfig.hpp"
+
+class MemoryManager;
+struct PCB;
+
+class CacheHierarchy {
+public:
+    struct CoreCaches {
+        Cache *l1i;
+        Cache *l1d;
+    };
+
+    CacheHierarchy(const CacheConfig &l1dConfig, const CacheConfig &l1iConfig, const CacheConfig &l2Config,
+                   const CoherenceConfig &coherence, MemoryManager *memory);
+
+    // Cria as L1 de mais um núcleo; os ponteiros valem enquanto a hierarquia existir
+    CoreCaches addCore();
+
+    // Endereço físico; l1d / l1i = cache do núcleo que acessa (nullptr = sem L1)
+    uint32_t read(Cache *l1d, size_t address, PCB &process);
+    void write(Cache *l1d, size_t address, uint32_t value, PCB &process);
+    // Busca de instrução pela L1I
+    uint32_t fetch(Cache *l1i, size_t address, PCB &process);
+    // Traz a linha para a L1D sem cobrar o acesso: ela fica pronta depois da
+    // latência do BusRd (relógio do processo). false se a linha já estava lá.
+    bool prefetch(Cache *l1d, size_t address, PCB &process);
+
+    // Escreve de volta e descarta de todos os níveis as linhas de
+    // [base, base + size). Usado quando o frame muda de dono (swapOut).
+    void flushRange(size_t base, size_t size);
+
+private:
+    // Leitura com BusRd no miss; instruction = a L1 é uma L1I
+    uint32_t load(Cache *l1, size_t address, PCB &process, bool instruction);
+
+    // Acerto de demanda: conta o primeiro uso de uma linha de prefetch e
+    // cobra a espera se ela ainda não estava pronta
+    void usePrefetched(Cache &l1, size_t address, PCB &process);
+    // Ciclos já gastos pelo processo (pipeline + memória)
+    static uint64_t processClock(const PCB &process);
+
+    // As funções abaixo são chamadas com busMutex travado e devolvem o custo em ciclos
+    // BusRd: a linha vem de outra L1 (que fica Shared), da L2 ou da RAM.
+    // shared = outra L1 continua com cópia
+    uint64_t busRead(const Cache *requester, size_t line, uint32_t *words, bool &shared, PCB &process);
+    // Linha vinda da L2 (ou da RAM, instalando-a na L2)
+    uint64_t fetchFromL2(size_t line, uint32_t *words, PCB &process);
+    // Linha que saiu da L1: se Modified, atualiza a L2
+    void retireFromL1(const EvictedLine &evicted, PCB &process);
+    // Linha que saiu da L2: invalida as cópias nas L1 e, se suja, escreve na RAM
+    void retireFromL2(EvictedLine &evicted);
+    void writeLineToMemory(size_t line, const uint32_t *words);
+
+    uint64_t l1HitCost(const Cache &l1, const PCB &process) const;
+    uint64_t l2HitCost(const PCB &process) const;
+    uint64_t memoryCost(const PCB &process) const;
+
+    CacheConfig l1dCfg;
+    CacheConfig l1iCfg;
+    CoherenceConfig coherence;
+    MemoryManager *memory;
+
+    std::vector<std::unique_ptr<Cache>> l1s;   // L1D e L1I de todos os núcleos
+    Cache l2;
+    std::mutex busMutex;
+};
+
+#endif
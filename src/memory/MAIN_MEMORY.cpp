@@ -1,38 +1,48 @@
 #include "MAIN_MEMORY.hpp"
+#include <algorithm>
+#include <cstring>
 
-MAIN_MEMORY::MAIN_MEMORY(size_t size)
+static size_t clampSize(size_t size)
 {
-    if (size > MAX_MEMORY_SIZE)
-        this->size = MAX_MEMORY_SIZE;
-    else
-        this->size = size;
+    return size > MAX_MEMORY_SIZE ? MAX_MEMORY_SIZE : size;
+}
 
-    this->ram.resize(this->size, MEMORY_ACCESS_ERROR);
+MAIN_MEMORY::MAIN_MEMORY(size_t size) : size(clampSize(size)), ram(clampSize(size), MEMORY_ACCESS_ERROR)
+{
 }
 
 MAIN_MEMORY::~MAIN_MEMORY()
 {
-    this->ram.clear();
 }
 
 bool MAIN_MEMORY::isEmpty()
 {
-    for (auto &val : ram)
-        if (val != MEMORY_ACCESS_ERROR) return false;
+    for (size_t i = 0; i < size; ++i)
+    {
+        const uint32_t *val = ram.find(i);
+        if (val && *val != MEMORY_ACCESS_ERROR) return false;
+    }
     return true;
 }
 
 bool MAIN_MEMORY::notFull()
 {
-    for (auto &val : ram)
-        if (val == MEMORY_ACCESS_ERROR) return true;
+    for (size_t i = 0; i < size; ++i)
+    {
+        const uint32_t *val = ram.find(i);
+        if (!val || *val == MEMORY_ACCESS_ERROR) return true;
+    }
     return false;
 }
 
 uint32_t MAIN_MEMORY::ReadMem(uint32_t address)
 {
     if (address < this->size)
-        return ram[address];
+    {
+        // Bloco ainda não criado: nada foi escrito nele
+        const uint32_t *val = ram.find(address);
+        return val ? *val : MEMORY_ACCESS_ERROR;
+    }
     return MEMORY_ACCESS_ERROR;
 }
 
@@ -48,7 +58,7 @@ uint32_t MAIN_MEMORY::WriteMem(uint32_t address, uint32_t data)
 
 uint32_t MAIN_MEMORY::DeleteData(uint32_t address)
 {
-    if (address < this->size && ram[address] != MEMORY_ACCESS_ERROR)
+    if (address < this->size && ReadMem(address) != MEMORY_ACCESS_ERROR)
     {
         uint32_t deletedData = ram[address];
         ram[address] = MEMORY_ACCESS_ERROR;
@@ -56,3 +66,44 @@ uint32_t MAIN_MEMORY::DeleteData(uint32_t address)
     }
     return MEMORY_ACCESS_ERROR;
 }
+
+void MAIN_MEMORY::readBlock(uint32_t address, uint32_t *out, size_t count)
+{
+    size_t done = 0;
+    while (done < count)
+    {
+        size_t at = static_cast<size_t>(address) + done;
+        if (at >= size)
+        {
+            std::fill_n(out + done, count - done, MEMORY_ACCESS_ERROR);
+            return;
+        }
+        // Até o fim do bloco atual (ou da memória)
+        size_t n = std::min({count - done, decltype(ram)::CHUNK - at % decltype(ram)::CHUNK, size - at});
+        const uint32_t *src = ram.find(at);
+        if (src)
+            std::memcpy(out + done, src, n * sizeof(uint32_t));
+        else
+            std::fill_n(out + done, n, MEMORY_ACCESS_ERROR);
+        done += n;
+    }
+}
+
+void MAIN_MEMORY::writeBlock(uint32_t address, const uint32_t *in, size_t count)
+{
+    size_t done = 0;
+    while (done < count)
+    {
+        size_t at = static_cast<size_t>(address) + done;
+        if (at >= size) return;
+        size_t n = std::min({count - done, decltype(ram)::CHUNK - at % decltype(ram)::CHUNK, size - at});
+        std::memcpy(ram.span(at, n), in + done, n * sizeof(uint32_t));
+        done += n;
+    }
+}
+
+uint32_t *MAIN_MEMORY::span(uint32_t address, size_t count)
+{
+    if (static_cast<size_t>(address) + count > size) return nullptr;
+    return ram.span(address, count);
+}
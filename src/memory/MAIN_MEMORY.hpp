@@ -3,19 +3,28 @@
 
 #include <cstdint>
 #include <vector>
+#include "SparseArray.hpp"
 
 #define MEMORY_ACCESS_ERROR UINT32_MAX
-#define MAX_MEMORY_SIZE 1024
+// Em palavras: 4 GiB menos uma página, para todo endereço físico em bytes
+// caber em 32 bits sem chegar a MEMORY_ACCESS_ERROR
+#define MAX_MEMORY_SIZE 0x3FFFFFF8
 
 using std::size_t;
 using std::uint32_t;
 using std::vector;
 
+/*
+  RAM simulada, em palavras. O conteúdo fica num SparseArray de blocos de
+  16 KiB criados na primeira escrita: uma memória de gigabytes só ocupa no
+  hospedeiro o que os processos tocaram. Palavra nunca escrita vale
+  MEMORY_ACCESS_ERROR.
+*/
 class MAIN_MEMORY
 {
 private:
     size_t size;
-    vector<uint32_t> ram;
+    SparseArray<uint32_t, 12> ram;
     bool notFull();
     bool isEmpty();
 
@@ -25,6 +34,16 @@ public:
     uint32_t ReadMem(uint32_t address);
     uint32_t WriteMem(uint32_t address, uint32_t data);
     uint32_t DeleteData(uint32_t address);
+    // Cópias em bloco (memcpy por bloco do SparseArray). Palavras fora da
+    // memória não são copiadas; na leitura valem MEMORY_ACCESS_ERROR.
+    void readBlock(uint32_t address, uint32_t *out, size_t count);
+    void writeBlock(uint32_t address, const uint32_t *in, size_t count);
+    // Trecho contíguo [address, address + count) para cópia direta; nullptr se
+    // sair da memória ou cruzar um bloco (uma página alinhada nunca cruza)
+    uint32_t *span(uint32_t address, size_t count);
+    size_t capacity() const { return size; }
+    // Bytes do hospedeiro ocupados pelos blocos já criados
+    size_t hostBytes() const { return ram.chunksAllocated() * decltype(ram)::CHUNK * sizeof(uint32_t); }
 };
 
 #endif
\ No newline at end of file
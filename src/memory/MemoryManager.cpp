@@ -1,192 +1,721 @@
 #include "MemoryManager.hpp"
+#include <algorithm>
 #include <iostream>
+#include "../trace/Console.hpp"
 
-MemoryManager::MemoryManager(size_t mainMemorySize, size_t secondaryMemorySize) 
-    : mainMemoryLimit(mainMemorySize), nextSwapAddress(0), victimFramePtr(0)
+// Depois do swapIn a página só guarda o lugar no disco enquanto a área de
+// swap estiver ocupada até SWAP_KEEP_NUM / SWAP_KEEP_DEN
+static constexpr size_t SWAP_KEEP_NUM = 3;
+static constexpr size_t SWAP_KEEP_DEN = 4;
+
+// Potência de 2 entre MIN_PAGE_SIZE e MAX_PAGE_SIZE, sem passar do pedido
+static size_t sanitizePageSize(size_t requested) {
+    size_t size = MIN_PAGE_SIZE;
+    while (size * 2 <= requested && size * 2 <= MAX_PAGE_SIZE) size *= 2;
+    return size;
+}
+
+MemoryManager::MemoryManager(size_t mainMemorySize, size_t secondaryMemorySize, const MemoryConfig& memoryConfig)
+    : config(memoryConfig),
+      pageBytes(sanitizePageSize(memoryConfig.pageSize)),
+      wordsPerPage(pageBytes / 4),
+      mainMemoryLimit(std::min<size_t>(mainMemorySize, static_cast<size_t>(MAX_MEMORY_SIZE) * 4)),
+      // Calcula frames. Se mainMemorySize=192 e a página tem 32 bytes, temos 6 frames.
+      numFrames(mainMemoryLimit / pageBytes),
+      frameOwnerTable(numFrames)
 {
-    mainMemory = std::make_unique<MAIN_MEMORY>(mainMemorySize);
-    secondaryMemory = std::make_unique<SECONDARY_MEMORY>(secondaryMemorySize);
-    L1_cache = std::make_unique<Cache>();
-    
-    // Calcula frames. Se mainMemorySize=192 e PAGE_SIZE=32, temos 6 frames.
-    numFrames = mainMemorySize / PAGE_SIZE;
-    framesMap.resize(numFrames, false); 
-    frameOwnerTable.resize(numFrames);
+    mainMemory = std::make_unique<MAIN_MEMORY>(mainMemoryLimit / 4);
+    secondaryMemory = std::make_unique<SECONDARY_MEMORY>(secondaryMemorySize, config.disk);
+    // Nenhuma linha de cache cruza páginas: o flush de uma página tem que pegar as linhas inteiras
+    for (CacheConfig* level : {&config.l1d, &config.l1i, &config.l2}) {
+        level->lineSize = static_cast<unsigned>(std::min<size_t>(level->lineSize, pageBytes));
+    }
+    caches = std::make_unique<CacheHierarchy>(config.l1d, config.l1i, config.l2, config.coherence, this);
+
+    frameLockCount = std::max<size_t>(1, std::min(numFrames, FRAME_LOCK_STRIPES));
+    frameLocks = std::make_unique<std::mutex[]>(frameLockCount);
+    replacer = std::make_unique<PageReplacer>(config.paging, numFrames,
+                                              [this](size_t frame, uint8_t clear) { return frameBits(frame, clear); });
+    // O disco inteiro é área de swap, um lugar por página
+    swap = std::make_unique<SwapSpace>(secondaryMemory->capacity() / wordsPerPage, wordsPerPage);
+
+    if (config.paging.async) pagingThread = std::thread(&MemoryManager::pagingLoop, this);
+}
+
+MemoryManager::~MemoryManager() {
+    {
+        std::lock_guard<std::mutex> lock(pagingMutex);
+        pagingStop = true;
+    }
+    pagingReady.notify_all();
+    if (pagingThread.joinable()) pagingThread.join();
 }
 
-int MemoryManager::swapOut() {
-    int victimIndex = victimFramePtr;
-    victimFramePtr = (victimFramePtr + 1) % numFrames; 
+// Chamado com allocMutex travado
+int MemoryManager::swapOut(PCB& requester, bool coreWaits) {
+    int victimIndex = static_cast<int>(replacer->selectVictim(accessClock.load(std::memory_order_relaxed)));
 
+    // Nenhum núcleo acessa o frame enquanto ele troca de dono
+    std::lock_guard<std::mutex> frameLock(frameMutex(victimIndex));
     FrameInfo& victimInfo = frameOwnerTable[victimIndex];
-    
+
     // Se o frame estiver vazio (erro de consistência), apenas retorna ele
-    if (victimInfo.ownerProcess == nullptr) {
+    if (victimInfo.ownerProcess == nullptr && victimInfo.image == nullptr) {
         return victimIndex;
     }
 
     PCB* victimPCB = victimInfo.ownerProcess;
+    SharedImage* victimImage = victimInfo.image;
     int victimPage = victimInfo.virtualPageNumber;
-    
-    // O disco é um vetor de palavras. 
-    // Uma página de 32 bytes tem 8 palavras (32 / 4).
-    uint32_t wordsPerPage = PAGE_SIZE / 4; 
+    // Página de imagem vai para o disco com a chave da imagem, não de um processo
+    int swapKey = victimImage ? victimImage->swapKey : victimPCB->pid;
 
-    uint32_t diskAddr = nextSwapAddress;
-    nextSwapAddress += wordsPerPage; // Avança apenas 8 posições no disco
+    // A página pode ter guardado o lugar no disco no swapIn: se a PTE não
+    // ficou suja, a cópia de lá ainda vale e a escrita é dispensada
+    uint32_t diskAddr = swap->find(swapKey, victimPage);
+    bool writeBack = diskAddr == SwapSpace::NO_SLOT || (frameBits(victimIndex, 0) & PageTable::DIRTY) != 0;
+    if (diskAddr == SwapSpace::NO_SLOT) {
+        diskAddr = swap->assign(swapKey, victimPage);
+        if (diskAddr == SwapSpace::NO_SLOT) {
+            std::cerr << "[SWAP] Disco cheio: Frame " << victimIndex << " (PID " << swapKey
+                      << ", Pag " << victimPage << ") fica na RAM\n";
+            return -1;
+        }
+    }
 
     // Calcula onde começa o frame na RAM (vetor de palavras)
-    // Frame 0 = índice 0. Frame 1 = índice 8. Frame 2 = índice 16...
-    uint32_t ramBaseIndex = victimIndex * wordsPerPage;
+    // Com páginas de 32 bytes: Frame 0 = índice 0. Frame 1 = índice 8...
+    uint32_t ramBaseIndex = static_cast<uint32_t>(victimIndex * wordsPerPage);
+
+    // As linhas das caches deste frame pertencem à página que sai: as sujas
+    // voltam para a RAM antes da cópia e nenhuma sobrevive para o próximo dono
+    caches->flushRange(static_cast<size_t>(victimIndex) * pageBytes, pageBytes);
 
-    // Loop ajustado: Itera 8 vezes (palavras), não 32.
-    for (size_t i = 0; i < wordsPerPage; i++) {
-        uint32_t data = mainMemory->ReadMem(ramBaseIndex + i);
-        secondaryMemory->WriteMem(diskAddr + i, data);
+    if (writeBack) {
+        // A página inteira de uma vez: o frame é contíguo num bloco da RAM
+        secondaryMemory->writeBlock(diskAddr, mainMemory->span(ramBaseIndex, wordsPerPage), wordsPerPage);
+        // Quem espera pelo frame espera a escrita no disco
+        chargeDisk(requester, diskAddr, true, coreWaits);
     }
 
-    swapTable[{victimPCB->pid, victimPage}] = diskAddr;
-    victimPCB->pageTable.erase(victimPage);
+    // Nenhum núcleo pode continuar traduzindo para este frame: a página sai
+    // de todos os processos que a mapeiam
+    if (victimImage != nullptr) {
+        victimImage->frames[victimPage - victimImage->firstPage] = -1;
+        bool mapped = false;
+        for (PCB* user : victimImage->users) {
+            if (unmapPage(*user, victimPage, victimIndex)) {
+                user->swap_outs.fetch_add(1);
+                mapped = true;
+            }
+        }
+        // Página da imagem que ninguém chegou a mapear: conta para quem a tirou
+        if (!mapped) requester.swap_outs.fetch_add(1);
+    } else if (unmapPage(*victimPCB, victimPage, victimIndex)) {
+        victimPCB->swap_outs.fetch_add(1);
+    }
+    victimInfo = FrameInfo{};
 
-    std::cout << "[SWAP-OUT] Frame " << victimIndex 
-              << " (PID " << victimPCB->pid << ", Pag " << victimPage << ")"
-              << " -> Disco @" << diskAddr << "\n";
+    SIM_TRACE(Swap, Info, "[SWAP-OUT] Frame " << victimIndex
+              << " (PID " << swapKey << ", Pag " << victimPage << ")"
+              << (writeBack ? " -> Disco @" : " limpa, ja no Disco @") << diskAddr << "\n");
 
     return victimIndex;
 }
 
-void MemoryManager::swapIn(int frameIndex, PCB& process, int virtualPage, uint32_t diskAddress) {
-    uint32_t wordsPerPage = PAGE_SIZE / 4; // 8 palavras
-    uint32_t ramBaseIndex = frameIndex * wordsPerPage;
+// Chamado com allocMutex e o frame de destino travados
+void MemoryManager::swapIn(int frameIndex, PCB& process, int virtualPage, uint32_t diskAddress, bool coreWaits) {
+    uint32_t ramBaseIndex = static_cast<uint32_t>(frameIndex * wordsPerPage);
+
+    // O frame não tem linhas na cache (foram descartadas no swapOut), então a
+    // RAM pode ser escrita direto, em bloco
+    secondaryMemory->readBlock(diskAddress, mainMemory->span(ramBaseIndex, wordsPerPage), wordsPerPage);
+
+    process.swap_ins.fetch_add(1);
+    chargeDisk(process, diskAddress, false, coreWaits);
+
+    SIM_TRACE(Swap, Info, "[SWAP-IN]  PID " << process.pid << ", Pag " << virtualPage
+              << " (Disco @" << diskAddress << ") -> Frame " << frameIndex << "\n");
+}
+
+// Chamado com allocMutex travado (a cabeça do disco só anda no caminho de swap)
+void MemoryManager::chargeDisk(PCB& payer, uint32_t diskAddress, bool isWrite, bool coreWaits) {
+    uint64_t cycles = config.disk.type == DiskType::Weighted
+                          ? payer.memWeights.secondary
+                          : secondaryMemory->transferLatency(diskAddress, wordsPerPage, isWrite);
+    payer.secondary_mem_accesses.fetch_add(1);
+    payer.disk_cycles.fetch_add(cycles);
+    if (coreWaits) payer.memory_cycles.fetch_add(cycles);
+}
 
-    // Loop ajustado: Itera 8 vezes
-    for (size_t i = 0; i < wordsPerPage; i++) {
-        uint32_t data = secondaryMemory->ReadMem(diskAddress + i);
-        mainMemory->WriteMem(ramBaseIndex + i, data);
+// Chamado com allocMutex travado. Devolve um frame livre, ainda sem dono
+int MemoryManager::allocateFrame(PCB& requester, bool coreWaits) {
+    if (!freeFrames.empty()) {
+        int frame = freeFrames.back();
+        freeFrames.pop_back();
+        recordResident();
+        return frame;
+    }
+    if (nextUnusedFrame < numFrames) {
+        int frame = static_cast<int>(nextUnusedFrame++);
+        recordResident();
+        return frame;
     }
+    // Memória cheia -> Swap Out
+    return swapOut(requester, coreWaits);
+}
 
-    swapTable.erase({process.pid, virtualPage});
+// Chamado com allocMutex travado
+void MemoryManager::recordResident() {
+    uint64_t now = accessClock.load(std::memory_order_relaxed);
+    size_t frames = nextUnusedFrame - freeFrames.size();
 
-    std::cout << "[SWAP-IN]  PID " << process.pid << ", Pag " << virtualPage 
-              << " (Disco @" << diskAddress << ") -> Frame " << frameIndex << "\n";
+    // Mesmo intervalo do último ponto: ele fica com o maior valor
+    if (!residentTimeline.empty() && now - residentTimeline.back().first < residentStride) {
+        residentTimeline.back().second = std::max(residentTimeline.back().second, frames);
+        return;
+    }
+    // Série cheia: junta os pontos dois a dois e os intervalos dobram
+    if (residentTimeline.size() >= RESIDENT_HISTORY_POINTS) {
+        size_t kept = 0;
+        for (size_t i = 0; i < residentTimeline.size(); i += 2, ++kept) {
+            residentTimeline[kept] = residentTimeline[i];
+            if (i + 1 < residentTimeline.size()) {
+                residentTimeline[kept].second = std::max(residentTimeline[i].second, residentTimeline[i + 1].second);
+            }
+        }
+        residentTimeline.resize(kept);
+        residentStride *= 2;
+    }
+    residentTimeline.emplace_back(now, frames);
 }
 
-int MemoryManager::allocateFrame(PCB& process, int virtualPage) {
-    for (size_t i = 0; i < framesMap.size(); ++i) {
-        if (!framesMap[i]) {
-            framesMap[i] = true; 
-            frameOwnerTable[i] = {&process, virtualPage};
-            return i;
+void MemoryManager::releaseProcess(PCB& process) {
+    std::lock_guard<std::mutex> lock(allocMutex);
+
+    // Só o page fault e o swap mexem na tabela, e os dois passam por allocMutex:
+    // a cópia continua valendo enquanto os frames são liberados
+    std::vector<std::pair<int, int>> pages;
+    {
+        std::shared_lock<std::shared_mutex> pageTableLock(process.pageTableMutex);
+        pages = process.pageTable.entries();
+    }
+
+    size_t released = 0;
+    for (const auto& [virtualPage, frame] : pages) {
+        bool shared;
+        {
+            std::lock_guard<std::mutex> frameLock(frameMutex(frame));
+            // Frame da imagem fica para os outros processos que a usam
+            shared = frameOwnerTable[frame].image != nullptr;
+            if (!shared) {
+                // O conteúdo não interessa mais, mas nenhuma linha pode sobrar para o próximo dono
+                caches->flushRange(static_cast<size_t>(frame) * pageBytes, pageBytes);
+                frameOwnerTable[frame] = FrameInfo{};
+                replacer->onRelease(frame);
+            }
+        }
+        for (auto& tlb : tlbs) tlb->invalidate(process.pid, virtualPage);
+        if (!shared) {
+            freeFrames.push_back(frame);
+            ++released;
         }
     }
-    // Memória cheia -> Swap Out
-    int freedFrame = swapOut();
-    frameOwnerTable[freedFrame] = {&process, virtualPage};
-    return freedFrame;
+    {
+        std::unique_lock<std::shared_mutex> pageTableLock(process.pageTableMutex);
+        process.pageTable.clear();
+    }
+    process.resident_pages.store(0);
+
+    size_t slots = swap->releaseProcess(process.pid);
+
+    // Último processo da imagem: os frames e os lugares no disco dela também voltam
+    if (SharedImage* image = process.image) {
+        process.image = nullptr;
+        image->users.erase(std::find(image->users.begin(), image->users.end(), &process));
+        if (image->users.empty()) {
+            for (int frame : image->frames) {
+                if (frame < 0) continue;
+                {
+                    std::lock_guard<std::mutex> frameLock(frameMutex(frame));
+                    caches->flushRange(static_cast<size_t>(frame) * pageBytes, pageBytes);
+                    frameOwnerTable[frame] = FrameInfo{};
+                    replacer->onRelease(frame);
+                }
+                freeFrames.push_back(frame);
+                ++released;
+            }
+            slots += swap->releaseProcess(image->swapKey);
+            images.erase(image->name);
+        }
+    }
+
+    if (released > 0) recordResident();
+    SIM_TRACE(Mmu, Info, "[MMU] PID " << process.pid << " terminou: " << released
+              << " frames e " << slots << " paginas no disco liberados\n");
 }
 
-uint32_t MemoryManager::translateAddress(uint32_t virtualAddress, PCB& process, bool isWrite) {
-    int pageNumber = virtualAddress / PAGE_SIZE;
-    int offset = virtualAddress % PAGE_SIZE;
+std::vector<std::pair<uint64_t, size_t>> MemoryManager::residentHistory() {
+    std::lock_guard<std::mutex> lock(allocMutex);
+    return residentTimeline;
+}
+
+CorePort* MemoryManager::attachCore() {
+    std::lock_guard<std::mutex> lock(allocMutex);
+    tlbs.push_back(std::make_unique<TLB>(config.tlb));
+    auto port = std::make_unique<CorePort>();
+    port->tlb = tlbs.back().get();
+    CacheHierarchy::CoreCaches l1 = caches->addCore();
+    port->l1i = l1.l1i;
+    port->l1d = l1.l1d;
+    port->prefetcher = std::make_unique<Prefetcher>(config.prefetch, port->l1d->lineSize());
+    ports.push_back(std::move(port));
+    return ports.back().get();
+}
+
+bool MemoryManager::frameHolds(const FrameInfo& owner, const PCB& process, int virtualPage) {
+    if (owner.virtualPageNumber != virtualPage) return false;
+    return owner.ownerProcess == &process || (owner.image != nullptr && owner.image == process.image);
+}
 
-    // 1. RAM Hit
-    if (process.pageTable.find(pageNumber) != process.pageTable.end()) {
-        int frameNumber = process.pageTable[pageNumber];
-        return (frameNumber * PAGE_SIZE) + offset;
+int MemoryManager::lookupPage(PCB& process, int virtualPage) {
+    std::shared_lock<std::shared_mutex> lock(process.pageTableMutex);
+    const PageTable::Entry* entry = process.pageTable.find(virtualPage);
+    return entry ? static_cast<int>(entry->frame) : -1;
+}
+
+int MemoryManager::walkPage(PCB& process, int virtualPage, PageTable::Entry*& pte) {
+    std::shared_lock<std::shared_mutex> lock(process.pageTableMutex);
+    pte = process.pageTable.find(virtualPage);
+    return pte ? static_cast<int>(pte->frame) : -1;
+}
+
+uint8_t MemoryManager::pageBits(PCB& process, int virtualPage, size_t frame, uint8_t clear) {
+    std::shared_lock<std::shared_mutex> lock(process.pageTableMutex);
+    PageTable::Entry* entry = process.pageTable.find(virtualPage);
+    if (entry == nullptr || entry->frame != frame) return 0;
+    uint8_t flags = clear ? entry->flags.fetch_and(static_cast<uint8_t>(~clear), std::memory_order_relaxed)
+                          : entry->flags.load(std::memory_order_relaxed);
+    return flags & (PageTable::REFERENCED | PageTable::DIRTY);
+}
+
+uint8_t MemoryManager::frameBits(size_t frame, uint8_t clear) {
+    const FrameInfo& owner = frameOwnerTable[frame];
+    if (owner.ownerProcess != nullptr) return pageBits(*owner.ownerProcess, owner.virtualPageNumber, frame, clear);
+    if (owner.image == nullptr) return 0;
+
+    uint8_t bits = 0;
+    for (PCB* user : owner.image->users) bits |= pageBits(*user, owner.virtualPageNumber, frame, clear);
+    // As PTEs da imagem são só de leitura e nunca ficam sujas: a página
+    // conta como suja enquanto não tiver cópia no disco
+    if (swap->find(owner.image->swapKey, owner.virtualPageNumber) == SwapSpace::NO_SLOT) bits |= PageTable::DIRTY;
+    return bits;
+}
+
+int MemoryManager::handlePageFault(PCB& process, int virtualPage, bool isWrite, bool canBlock) {
+    std::lock_guard<std::mutex> lock(allocMutex);
+
+    // Outro acesso pode ter resolvido a falta enquanto esperávamos a trava
+    int frame = lookupPage(process, virtualPage);
+    if (frame >= 0) return frame;
+
+    PageSource source = locatePage(process, virtualPage);
+    // Falta leve: a página da imagem já está na RAM por outro processo
+    int shared = residentImageFrame(source, virtualPage);
+    if (shared >= 0) {
+        mapPage(process, virtualPage, shared, false);
+        return shared;
     }
+    bool onDisk = source.diskAddress != SwapSpace::NO_SLOT;
+    if (!onDisk && !isWrite && source.image == nullptr) return -1;
+
+    process.page_faults.fetch_add(1);
 
-    // 2. Swap Hit (Está no disco)
-    auto swapEntry = swapTable.find({process.pid, pageNumber});
-    if (swapEntry != swapTable.end()) {
-        uint32_t diskAddr = swapEntry->second;
-        int newFrame = allocateFrame(process, pageNumber);
-        swapIn(newFrame, process, pageNumber, diskAddr);
-        process.pageTable[pageNumber] = newFrame;
-        return (newFrame * PAGE_SIZE) + offset;
+    // A página que o dispositivo acabou de trazer já saiu de novo (ou não coube):
+    // esta tentativa resolve na hora, para o processo não voltar a bloquear nela
+    bool retry = process.paged_in == virtualPage;
+    process.paged_in = -1;
+    bool needsDisk = onDisk || needsVictim();
+    if (canBlock && needsDisk && !retry) {
+        process.pending_page = virtualPage;
+        process.page_fault_blocks.fetch_add(1);
+        return PAGE_PENDING;
     }
+    return loadPage(process, virtualPage, source, true);
+}
 
-    // 3. Nova Alocação
-    if (isWrite) {
-        int newFrame = allocateFrame(process, pageNumber);
-        process.pageTable[pageNumber] = newFrame;
-        std::cout << "[MMU] PID " << process.pid << ": Alocado Frame " << newFrame << " para Pagina " << pageNumber << "\n";
-        return (newFrame * PAGE_SIZE) + offset;
-    } else {
-        return MEMORY_ACCESS_ERROR;
+void MemoryManager::startPageIn(PCB& process) {
+    {
+        std::lock_guard<std::mutex> lock(pagingMutex);
+        pagingQueue.push_back(&process);
     }
+    pagingReady.notify_one();
 }
 
-uint32_t MemoryManager::read(uint32_t virtualAddress, PCB& process) {
-    std::lock_guard<std::recursive_mutex> lock(memMutex);
+void MemoryManager::pagingLoop() {
+    while (true) {
+        PCB* process;
+        {
+            std::unique_lock<std::mutex> lock(pagingMutex);
+            pagingReady.wait(lock, [this] { return pagingStop || !pagingQueue.empty(); });
+            if (pagingStop) return;
+            process = pagingQueue.front();
+            pagingQueue.pop_front();
+        }
 
-    process.mem_accesses_total.fetch_add(1);
-    process.mem_reads.fetch_add(1);
+        int virtualPage = process->pending_page;
+        {
+            std::lock_guard<std::mutex> lock(allocMutex);
+            int mapped = lookupPage(*process, virtualPage);
+            if (mapped >= 0) {
+                // Escrita numa página da imagem (copyOnWrite): a cópia é feita aqui
+                if (frameOwnerTable[mapped].image != nullptr) copyImagePage(*process, virtualPage, mapped, false);
+            } else {
+                PageSource source = locatePage(*process, virtualPage);
+                int shared = residentImageFrame(source, virtualPage);
+                if (shared >= 0) {
+                    mapPage(*process, virtualPage, shared, false);
+                } else {
+                    // O processo espera bloqueado: o tempo de disco não passa pelo núcleo
+                    loadPage(*process, virtualPage, source, false);
+                }
+            }
+            process->paged_in = virtualPage;
+            process->pending_page = -1;
+        }
+        SIM_TRACE(Swap, Info, "[PAGING] PID " << process->pid << ", Pag " << virtualPage << " pronta\n");
+        process->state = State::Ready;
+    }
+}
 
-    uint32_t physicalAddress = translateAddress(virtualAddress, process, false);
+MemoryManager::PageSource MemoryManager::locatePage(PCB& process, int virtualPage) {
+    PageSource source;
+    source.diskAddress = swap->find(process.pid, virtualPage);
+    // Sem cópia própria (na RAM ela estaria na tabela): a página é a da imagem
+    if (source.diskAddress == SwapSpace::NO_SLOT && process.image != nullptr && process.image->contains(virtualPage)) {
+        source.image = process.image;
+        source.diskAddress = swap->find(source.image->swapKey, virtualPage);
+        // Página que loadImage não conseguiu guardar: não existe, como fora da imagem
+        if (source.diskAddress == SwapSpace::NO_SLOT && residentImageFrame(source, virtualPage) < 0) {
+            source.image = nullptr;
+        }
+    }
+    return source;
+}
 
-    if (physicalAddress == MEMORY_ACCESS_ERROR) {
-        return 0; 
+int MemoryManager::residentImageFrame(const PageSource& source, int virtualPage) {
+    return source.image ? source.image->frames[virtualPage - source.image->firstPage] : -1;
+}
+
+void MemoryManager::mapPage(PCB& process, int virtualPage, int frame, bool writable, bool dirty) {
+    uint64_t resident = process.resident_pages.fetch_add(1) + 1;
+    if (resident > process.peak_resident_pages.load()) process.peak_resident_pages.store(resident);
+
+    std::unique_lock<std::shared_mutex> pageTableLock(process.pageTableMutex);
+    process.pageTable.map(virtualPage, frame, writable, dirty);
+}
+
+bool MemoryManager::unmapPage(PCB& process, int virtualPage, int frame) {
+    {
+        std::unique_lock<std::shared_mutex> pageTableLock(process.pageTableMutex);
+        if (!process.pageTable.unmap(virtualPage, frame)) return false;
     }
+    // Shootdown: nenhum núcleo pode continuar traduzindo para o frame
+    for (auto& tlb : tlbs) tlb->invalidate(process.pid, virtualPage);
+    process.resident_pages.fetch_sub(1);
+    return true;
+}
 
-    size_t cache_data = L1_cache->get(physicalAddress);
-    if (cache_data != CACHE_MISS) { 
-        process.cache_mem_accesses.fetch_add(1);
-        process.memory_cycles.fetch_add(process.memWeights.cache);
-        contabiliza_cache(process, true);
-        return static_cast<uint32_t>(cache_data);
+// Chamado com allocMutex travado
+int MemoryManager::loadPage(PCB& process, int virtualPage, const PageSource& source, bool coreWaits) {
+    uint32_t diskAddress = source.diskAddress;
+    bool onDisk = diskAddress != SwapSpace::NO_SLOT;
+    int swapKey = source.image ? source.image->swapKey : process.pid;
+    int newFrame = allocateFrame(process, coreWaits);
+    if (newFrame < 0) return -1;
+    bool keepCopy = false;
+    {
+        std::lock_guard<std::mutex> frameLock(frameMutex(newFrame));
+        // Swap Hit (Está no disco)
+        if (onDisk) {
+            swapIn(newFrame, process, virtualPage, diskAddress, coreWaits);
+            // Com folga no disco a página guarda o lugar (e a cópia) para sair
+            // sem escrita se não for alterada; com o disco apertado o lugar volta
+            // para a área livre e a página passa a contar como suja
+            keepCopy = swap->used() * SWAP_KEEP_DEN <= swap->capacity() * SWAP_KEEP_NUM;
+            if (!keepCopy) swap->release(swapKey, virtualPage);
+        } else {
+            SIM_TRACE(Mmu, Info, "[MMU] PID " << process.pid << ": Alocado Frame " << newFrame << " para Pagina " << virtualPage << "\n");
+        }
+        replacer->onLoad(newFrame, accessClock.load(std::memory_order_relaxed));
+        if (source.image != nullptr) {
+            frameOwnerTable[newFrame] = {nullptr, virtualPage, source.image};
+            source.image->frames[virtualPage - source.image->firstPage] = newFrame;
+        } else {
+            frameOwnerTable[newFrame] = {&process, virtualPage, nullptr};
+        }
     }
+    // Página da imagem entra só de leitura: a escrita faz a cópia.
+    // Página sem cópia no disco entra suja
+    mapPage(process, virtualPage, newFrame, source.image == nullptr, !keepCopy);
+    return newFrame;
+}
 
-    contabiliza_cache(process, false);
-    uint32_t data_from_mem = 0;
-    
-    if (physicalAddress < mainMemoryLimit) {
-        process.primary_mem_accesses.fetch_add(1);
-        process.memory_cycles.fetch_add(process.memWeights.primary);
-        // Endereço Físico (bytes) / 4 = Índice do Vetor (palavras)
-        data_from_mem = mainMemory->ReadMem(physicalAddress / 4);
-    } else {
-        process.secondary_mem_accesses.fetch_add(1);
-        process.memory_cycles.fetch_add(process.memWeights.secondary);
-        uint32_t secondaryAddress = physicalAddress - mainMemoryLimit;
-        data_from_mem = secondaryMemory->ReadMem(secondaryAddress / 4);
+int MemoryManager::copyOnWrite(PCB& process, int virtualPage, bool canBlock) {
+    std::lock_guard<std::mutex> lock(allocMutex);
+
+    // Outro acesso do processo pode ter feito a cópia enquanto esperávamos a trava
+    int shared = lookupPage(process, virtualPage);
+    if (shared < 0 || frameOwnerTable[shared].image == nullptr) return 0;
+
+    // Como na falta: a cópia que precisa tirar uma página da RAM espera o
+    // disco bloqueada, e a cópia que já voltou do dispositivo resolve na hora
+    bool retry = process.paged_in == virtualPage;
+    process.paged_in = -1;
+    if (canBlock && !retry && needsVictim()) {
+        process.pending_page = virtualPage;
+        process.page_fault_blocks.fetch_add(1);
+        return PAGE_PENDING;
+    }
+    return copyImagePage(process, virtualPage, shared, true) ? 0 : -1;
+}
+
+bool MemoryManager::copyImagePage(PCB& process, int virtualPage, int shared, bool coreWaits) {
+    SharedImage* image = frameOwnerTable[shared].image;
+    int frame = allocateFrame(process, coreWaits);
+    // Sem frame a página continua mapeada da imagem (só leitura) e a escrita falha
+    if (frame < 0) return false;
+
+    uint32_t ramBaseIndex = static_cast<uint32_t>(frame * wordsPerPage);
+    // O swapOut pode ter escolhido o próprio frame da imagem: aí a cópia vem do disco
+    int source = image->frames[virtualPage - image->firstPage];
+    {
+        std::lock_guard<std::mutex> frameLock(frameMutex(frame));
+        if (source >= 0) {
+            // Página da imagem nunca é escrita pelas caches: a RAM está em dia e
+            // a cópia é direta, de frame para frame
+            const uint32_t* from = mainMemory->span(static_cast<size_t>(source) * wordsPerPage, wordsPerPage);
+            std::copy(from, from + wordsPerPage, mainMemory->span(ramBaseIndex, wordsPerPage));
+        } else {
+            uint32_t diskAddress = swap->find(image->swapKey, virtualPage);
+            if (diskAddress != SwapSpace::NO_SLOT) swapIn(frame, process, virtualPage, diskAddress, coreWaits);
+        }
+        replacer->onLoad(frame, accessClock.load(std::memory_order_relaxed));
+        frameOwnerTable[frame] = {&process, virtualPage, nullptr};
+    }
+    // Com a cópia pronta a página sai da imagem (se o swapOut já não a tirou)
+    unmapPage(process, virtualPage, shared);
+    mapPage(process, virtualPage, frame, true, true);
+    process.cow_copies.fetch_add(1);
+
+    SIM_TRACE(Mmu, Info, "[MMU] PID " << process.pid << ": copia da Pagina " << virtualPage
+              << " da imagem no Frame " << frame << "\n");
+    return true;
+}
+
+bool MemoryManager::loadImage(PCB& process, const std::string& name, uint32_t startAddress, const std::vector<uint32_t>& words) {
+    if (words.empty()) return true;
+    int firstPage = static_cast<int>(startAddress / pageBytes);
+    size_t endAddress = startAddress + words.size() * 4;
+    size_t pageCount = (endAddress + pageBytes - 1) / pageBytes - firstPage;
+
+    {
+        std::lock_guard<std::mutex> lock(allocMutex);
+        auto found = images.find(name);
+        if (found == images.end()) {
+            auto image = std::make_unique<SharedImage>();
+            image->name = name;
+            image->swapKey = nextImageKey--;
+            image->firstPage = firstPage;
+            image->frames.assign(pageCount, -1);
+            image->users.push_back(&process);
+            process.image = image.get();
+
+            // Cópia direta para a RAM: os frames novos não têm linhas nas caches.
+            // Palavras da página fora da imagem ficam como estavam.
+            bool loaded = true;
+            for (size_t i = 0; i < pageCount; ++i) {
+                int page = firstPage + static_cast<int>(i);
+                int frame = allocateFrame(process, true);
+                if (frame < 0) {
+                    // Sem frame é porque o disco encheu (o swapOut não achou
+                    // lugar para a vítima): o resto da imagem fica de fora
+                    std::cerr << "[SWAP] Disco cheio: imagem " << name << " perde as paginas "
+                              << page << " a " << firstPage + static_cast<int>(pageCount) - 1 << "\n";
+                    loaded = false;
+                    break;
+                }
+                process.page_faults.fetch_add(1);
+
+                size_t pageStart = static_cast<size_t>(page) * pageBytes;
+                size_t from = std::max<size_t>(pageStart, startAddress);
+                size_t to = std::min(pageStart + pageBytes, endAddress);
+                {
+                    std::lock_guard<std::mutex> frameLock(frameMutex(frame));
+                    mainMemory->writeBlock(static_cast<uint32_t>(frame * wordsPerPage + (from - pageStart) / 4),
+                                           &words[(from - startAddress) / 4], (to - from) / 4);
+                    replacer->onLoad(frame, accessClock.load(std::memory_order_relaxed));
+                    frameOwnerTable[frame] = {nullptr, page, image.get()};
+                }
+                image->frames[i] = frame;
+            }
+            SIM_TRACE(Mmu, Info, "[MMU] Imagem " << name << " carregada: " << pageCount << " paginas\n");
+            images.emplace(name, std::move(image));
+            return loaded;
+        }
+        SharedImage& image = *found->second;
+        if (image.firstPage == firstPage && image.frames.size() == pageCount) {
+            image.users.push_back(&process);
+            process.image = &image;
+            SIM_TRACE(Mmu, Info, "[MMU] PID " << process.pid << " compartilha a imagem " << name << "\n");
+            return true;
+        }
+    }
+    // Mesmo arquivo em outro endereço: páginas próprias
+    for (size_t i = 0; i < words.size(); ++i) {
+        write(static_cast<uint32_t>(startAddress + i * 4), words[i], process);
+    }
+    return true;
+}
+
+uint32_t MemoryManager::lockTranslation(uint32_t virtualAddress, PCB& process, bool isWrite, TLB* tlb, bool canBlock,
+                                        std::unique_lock<std::mutex>& frameLock) {
+    int pageNumber = virtualAddress / pageBytes;
+    int offset = virtualAddress % pageBytes;
+    bool useTlb = tlb != nullptr && tlb->enabled();
+
+    while (true) {
+        int frame = -1;
+        PageTable::Entry* pte = nullptr;
+        uint32_t tlbFrame;
+
+        // 0. TLB do núcleo
+        if (useTlb && tlb->lookup(process.pid, pageNumber, tlbFrame, pte)) {
+            process.tlb_hits.fetch_add(1);
+            frame = static_cast<int>(tlbFrame);
+        } else {
+            if (useTlb) {
+                // Miss: a tradução vem da tabela de páginas, que está na memória
+                // principal; cada nível percorrido é um acesso a ela
+                uint64_t walkCycles = PageTable::LEVELS * process.memWeights.primary;
+                process.tlb_misses.fetch_add(1);
+                process.page_walk_cycles.fetch_add(walkCycles);
+                process.memory_cycles.fetch_add(walkCycles);
+            }
+            // 1. RAM Hit; 2. Swap Hit ou 3. Nova Alocação
+            frame = walkPage(process, pageNumber, pte);
+            if (frame < 0) {
+                // A instrução refaz o acesso depois da falta, como no hardware
+                // Inexistente ou pendente (PAGE_PENDING): o acesso não acontece
+                if (handlePageFault(process, pageNumber, isWrite, canBlock) < 0) return MEMORY_ACCESS_ERROR;
+                continue;
+            }
+            if (useTlb) tlb->insert(process.pid, pageNumber, frame, pte);
+        }
+
+        // Escrita em página só de leitura (imagem compartilhada): copia e traduz
+        // de novo (a cópia derruba a tradução antiga dos TLBs)
+        if (isWrite && !pte->has(PageTable::WRITABLE)) {
+            if (copyOnWrite(process, pageNumber, canBlock) < 0) return MEMORY_ACCESS_ERROR;
+            continue;
+        }
+
+        // O frame pode ter sido tomado por um swapOut entre a tradução e a trava:
+        // nesse caso a tradução (inclusive a do TLB) é descartada e refeita
+        frameLock = std::unique_lock<std::mutex>(frameMutex(frame));
+        const FrameInfo& owner = frameOwnerTable[frame];
+        if (frameHolds(owner, process, pageNumber)) {
+            // Bits R/D da PTE para a substituição de páginas
+            pte->set(isWrite ? PageTable::REFERENCED | PageTable::DIRTY : PageTable::REFERENCED);
+            accessClock.fetch_add(1, std::memory_order_relaxed);
+            process.resident_pages_sum.fetch_add(process.resident_pages.load(std::memory_order_relaxed),
+                                                 std::memory_order_relaxed);
+            return (frame * pageBytes) + offset;
+        }
+        frameLock.unlock();
+        if (useTlb) tlb->invalidate(process.pid, pageNumber);
     }
+}
+
+uint32_t MemoryManager::read(uint32_t virtualAddress, PCB& process, CorePort* port, uint32_t pc) {
+    process.mem_accesses_total.fetch_add(1);
+    process.mem_reads.fetch_add(1);
+
+    uint32_t value;
+    {
+        std::unique_lock<std::mutex> frameLock;
+        uint32_t physicalAddress = lockTranslation(virtualAddress, process, false, port ? port->tlb : nullptr, port != nullptr && config.paging.async, frameLock);
 
-    L1_cache->put(physicalAddress, data_from_mem, this);
-    return data_from_mem;
+        if (physicalAddress == MEMORY_ACCESS_ERROR) {
+            return 0;
+        }
+
+        value = caches->read(port ? port->l1d : nullptr, physicalAddress, process);
+    }
+    // Fora da trava do frame: o prefetch trava os frames das linhas sugeridas
+    prefetchAfter(virtualAddress, pc, process, port);
+    return value;
 }
 
-void MemoryManager::write(uint32_t virtualAddress, uint32_t data, PCB& process) {
-    std::lock_guard<std::recursive_mutex> lock(memMutex);
+uint32_t MemoryManager::fetch(uint32_t virtualAddress, PCB& process, CorePort* port) {
+    process.mem_accesses_total.fetch_add(1);
+    process.mem_reads.fetch_add(1);
+
+    std::unique_lock<std::mutex> frameLock;
+    uint32_t physicalAddress = lockTranslation(virtualAddress, process, false, port ? port->tlb : nullptr, port != nullptr && config.paging.async, frameLock);
 
+    if (physicalAddress == MEMORY_ACCESS_ERROR) {
+        return 0;
+    }
+
+    return caches->fetch(port ? port->l1i : nullptr, physicalAddress, process);
+}
+
+void MemoryManager::write(uint32_t virtualAddress, uint32_t data, PCB& process, CorePort* port, uint32_t pc) {
     process.mem_accesses_total.fetch_add(1);
     process.mem_writes.fetch_add(1);
 
-    uint32_t physicalAddress = translateAddress(virtualAddress, process, true);
-    if (physicalAddress == MEMORY_ACCESS_ERROR) return;
+    {
+        std::unique_lock<std::mutex> frameLock;
+        uint32_t physicalAddress = lockTranslation(virtualAddress, process, true, port ? port->tlb : nullptr, port != nullptr && config.paging.async, frameLock);
+        if (physicalAddress == MEMORY_ACCESS_ERROR) return;
 
-    if (physicalAddress < mainMemoryLimit) {
-        process.primary_mem_accesses.fetch_add(1);
-        process.memory_cycles.fetch_add(process.memWeights.primary);
-        // Endereço Físico (bytes) / 4 = Índice do Vetor (palavras)
-        mainMemory->WriteMem(physicalAddress / 4, data);
-    } else {
-        uint32_t secondaryAddress = physicalAddress - mainMemoryLimit;
-        secondaryMemory->WriteMem(secondaryAddress / 4, data);
+        // Escrita em página de código: descarta os micro-ops decodificados dela
+        uint32_t pageBase = (virtualAddress / pageBytes) * pageBytes;
+        process.decodeCache.invalidatePage(pageBase, pageBytes);
+
+        caches->write(port ? port->l1d : nullptr, physicalAddress, data, process);
     }
-    
-    size_t cacheCheck = L1_cache->get(physicalAddress);
-    if (cacheCheck != CACHE_MISS) {
-        L1_cache->update(physicalAddress, data);
-        contabiliza_cache(process, true); 
-    } else {
-        L1_cache->put(physicalAddress, data, this);
-        contabiliza_cache(process, false);
+    prefetchAfter(virtualAddress, pc, process, port);
+}
+
+void MemoryManager::prefetchAfter(uint32_t virtualAddress, uint32_t pc, PCB& process, CorePort* port) {
+    if (port == nullptr || !port->prefetcher || !port->prefetcher->enabled()) return;
+
+    for (uint32_t target : port->prefetcher->onAccess(pc, virtualAddress)) {
+        // Só páginas já na RAM: prefetch não provoca page fault nem passa pelo TLB
+        int page = target / pageBytes;
+        int frame = lookupPage(process, page);
+        if (frame < 0) continue;
+
+        std::lock_guard<std::mutex> frameLock(frameMutex(frame));
+        const FrameInfo& owner = frameOwnerTable[frame];
+        if (!frameHolds(owner, process, page)) continue;
+
+        uint32_t physicalAddress = frame * pageBytes + target % pageBytes;
+        if (caches->prefetch(port->l1d, physicalAddress, process)) {
+            SIM_TRACE(Memory, Debug, "[PREFETCH] PID " << process.pid << " VA " << target
+                      << " -> PA " << physicalAddress << "\n");
+        }
     }
-    
-    process.cache_mem_accesses.fetch_add(1);
-    process.memory_cycles.fetch_add(process.memWeights.cache);
 }
 
+// Linha trazida para a L2; chamado com o barramento da CacheHierarchy travado
+uint32_t MemoryManager::readFromFile(uint32_t address) {
+    return mainMemory->ReadMem(address / 4);
+}
+
+// Write-back da L2 (ou de uma linha da L1 fora dela); chamado com o barramento travado
 void MemoryManager::writeToFile(uint32_t address, uint32_t data) {
     if (address < mainMemoryLimit) {
         mainMemory->WriteMem(address / 4, data);
@@ -194,4 +723,4 @@ void MemoryManager::writeToFile(uint32_t address, uint32_t data) {
         uint32_t secondaryAddress = address - mainMemoryLimit;
         secondaryMemory->WriteMem(secondaryAddress / 4, data);
     }
-}
\ No newline at end of file
+}
@@ -1,74 +1,245 @@
 #ifndef MEMORY_MANAGER_HPP
 #define MEMORY_MANAGER_HPP
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <memory>
 #include <stdexcept>
-#include <mutex> 
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 #include <algorithm>
-#include <map>
 #include "MAIN_MEMORY.hpp"
 #include "SECONDARY_MEMORY.hpp"
-#include "cache.hpp" 
+#include "CacheHierarchy.hpp"
+#include "TLB.hpp"
+#include "Prefetcher.hpp"
+#include "PageReplacement.hpp"
+#include "SwapSpace.hpp"
+#include "PageSize.hpp"
 #include "../cpu/PCB.hpp" 
 
-// 32 palavras por página, não sei se o tamanho é esse.
-const size_t PAGE_SIZE = 32;
+// Travas de frame; frames além disso compartilham uma trava
+const size_t FRAME_LOCK_STRIPES = 4096;
+// Pontos guardados da série de frames ocupados (residentHistory)
+const size_t RESIDENT_HISTORY_POINTS = 4096;
+// handlePageFault: a falta ficou com o dispositivo de paginação
+const int PAGE_PENDING = -2;
+
+// Imagem de programa (dados iniciais + código) carregada uma vez e mapeada em
+// todos os processos que executam o mesmo arquivo. As páginas são só de
+// leitura: a primeira escrita de um processo numa delas dá a ele uma cópia
+// própria (copy-on-write).
+struct SharedImage {
+    std::string name;            // program_path de onde veio
+    int swapKey;                 // "PID" das páginas dela na área de swap (negativo)
+    int firstPage;
+    std::vector<int> frames;     // página - firstPage -> frame, ou -1 (no disco)
+    std::vector<PCB*> users;
+
+    bool contains(int page) const {
+        return page >= firstPage && page < firstPage + static_cast<int>(frames.size());
+    }
+};
 
 struct FrameInfo {
     PCB* ownerProcess = nullptr;
     int virtualPageNumber = -1;
+    SharedImage* image = nullptr;   // página de imagem compartilhada (sem ownerProcess)
 };
 
+// Caminho de um núcleo até a memória: o TLB, as L1 e o prefetcher privados dele
+struct CorePort {
+    TLB* tlb = nullptr;
+    Cache* l1i = nullptr;   // busca de instruções
+    Cache* l1d = nullptr;   // LW / SW
+    std::unique_ptr<Prefetcher> prefetcher;
+};
 
 
 class MemoryManager {
 public:
-    MemoryManager(size_t mainMemorySize, size_t secondaryMemorySize);
+    MemoryManager(size_t mainMemorySize, size_t secondaryMemorySize, const MemoryConfig& memoryConfig = MemoryConfig{});
+    ~MemoryManager();
 
     // Agora o endereço recebido é virtual 
-    uint32_t read(uint32_t virtualAddress, PCB& process);
-    void write(uint32_t virtualAddress, uint32_t data, PCB& process);
+    // port: TLB e L1 do núcleo que faz o acesso (nullptr = tabela de páginas e L2 direto)
+    // pc: instrução que faz o acesso (treina o prefetcher por PC)
+    uint32_t read(uint32_t virtualAddress, PCB& process, CorePort* port = nullptr, uint32_t pc = 0);
+    void write(uint32_t virtualAddress, uint32_t data, PCB& process, CorePort* port = nullptr, uint32_t pc = 0);
+    // Busca de instrução: como read, mas pela L1I do núcleo
+    uint32_t fetch(uint32_t virtualAddress, PCB& process, CorePort* port = nullptr);
+
+    /*
+        Paginação assíncrona (memory.paging.async): um acesso de núcleo (port
+        != nullptr) cuja falta precisa do disco (página em swap ou RAM sem
+        frame livre) não espera a transferência. O acesso devolve sem efeito e
+        deixa a página em process.pending_page; o núcleo interrompe o ciclo,
+        bloqueia o processo e o entrega a startPageIn. O dispositivo de
+        paginação (uma thread) traz a página e põe o processo em Ready. Faltas
+        sem disco (primeiro acesso com frame livre) continuam síncronas. A
+        cópia de uma página da imagem (copy-on-write) segue a mesma regra.
+    */
+    // Coloca a falta pendente do processo na fila do dispositivo de paginação
+    void startPageIn(PCB& process);
+
+    // Cria o TLB e as L1 de um núcleo. O MemoryManager guarda os TLBs para o
+    // shootdown no swapOut; o ponteiro vale enquanto o MemoryManager existir.
+    CorePort* attachCore();
+
+    size_t pageSize() const { return pageBytes; }
+
+    // memory.paging.share_images: o carregador entrega a imagem inteira a loadImage
+    bool sharesImages() const { return config.paging.shareImages; }
+    // Mapeia no processo a imagem name, que começa em startAddress. Só o primeiro
+    // processo de cada imagem copia words para a RAM; os outros reaproveitam os
+    // frames dela. Uma imagem de mesmo nome com outro leiaute é carregada como
+    // páginas próprias do processo. Devolve false se o disco encheu no meio da
+    // carga (sem vítima, não há frame): as páginas restantes ficam de fora.
+    bool loadImage(PCB& process, const std::string& name, uint32_t startAddress, const std::vector<uint32_t>& words);
+
+    // Processo terminou: devolve os frames e os lugares no disco dele (e os da
+    // imagem, se era o último a usá-la). Nenhum núcleo pode estar executando o processo.
+    void releaseProcess(PCB& process);
+    // Frames ocupados ao longo da execução: (relógio de acessos, frames em uso).
+    // No máximo RESIDENT_HISTORY_POINTS pontos; cada um é o maior valor do seu
+    // intervalo de acessos, então o pico é exato
+    std::vector<std::pair<uint64_t, size_t>> residentHistory();
     
-    // Função auxiliar para o write-back da cache
+    // Funções auxiliares para o preenchimento e o write-back das linhas da cache
+    uint32_t readFromFile(uint32_t address);
     void writeToFile(uint32_t address, uint32_t data);
 
 private:
+    MemoryConfig config;
+    size_t pageBytes;      // tamanho da página em uso
+    size_t wordsPerPage;
     std::unique_ptr<MAIN_MEMORY> mainMemory;
     std::unique_ptr<SECONDARY_MEMORY> secondaryMemory;
-    std::unique_ptr<Cache> L1_cache; // Adiciona a Cache L1
+    std::unique_ptr<CacheHierarchy> caches; // L1I/L1D de cada núcleo + L2 compartilhada
+    std::vector<std::unique_ptr<TLB>> tlbs; // um por núcleo
+    std::vector<std::unique_ptr<CorePort>> ports;
 
     /*
-        Nessa parte aqui eu usei o recursive_mutex porque a função de tradução de endereço
-        pode ser chamada dentro de read/write, que já travam o mutex. Assim evitamos deadlock.
-        Não consegui fazer usando só mutex, tive que pedir ajuda ao gemini kkkk.
+        Travas (sempre adquiridas nesta ordem, nunca ao contrário):
+        - allocMutex: alocador de frames e caminho de swap (freeFrames, swap,
+          escolha da vítima, memória secundária). Só o page fault passa por ela.
+        - frameMutex(f): dono do frame f e o conteúdo dele. Quem acessa a memória
+          trava o frame e confere em frameOwnerTable que ele ainda é da página
+          traduzida; o swapOut trava o mesmo frame antes de tirá-lo do processo.
+          Frames distantes FRAME_LOCK_STRIPES posições dividem a mesma trava;
+          ninguém trava dois frames ao mesmo tempo, então isso não trava.
+        - PCB::pageTableMutex: tabela de páginas de cada processo (leitura compartilhada).
+        - travas da CacheHierarchy (barramento e depois os conjuntos das L1).
+        O TLB de cada núcleo tem a própria trava, usada sem nenhuma das outras no
+        caminho rápido. pagingMutex (fila do dispositivo de paginação) também é
+        travada sozinha.
     */
-    std::recursive_mutex memMutex; 
+    std::mutex allocMutex;
+    std::unique_ptr<std::mutex[]> frameLocks;
+    size_t frameLockCount;
+    std::mutex& frameMutex(size_t frame) { return frameLocks[frame % frameLockCount]; }
 
-    size_t mainMemoryLimit;
+    size_t mainMemoryLimit;   // bytes
     size_t numFrames;
 
+    // Frames ainda nunca usados são [nextUnusedFrame, numFrames); os liberados
+    // por processos que terminaram ficam numa pilha. Alocar e liberar são O(1)
+    // e nada cresce com o tamanho da RAM.
+    size_t nextUnusedFrame = 0;
+    std::vector<int> freeFrames;
+    std::vector<std::pair<uint64_t, size_t>> residentTimeline;
+    uint64_t residentStride = 1;   // acessos cobertos por ponto; dobra quando a série enche
+    SparseArray<FrameInfo> frameOwnerTable;
 
-    std::vector<bool>framesMap;
-    std::vector<FrameInfo> frameOwnerTable;
-
-    // Tabela de Swap: {PID, PáginaVirtual} -> EndereçoFísicoNoDisco
-    std::map<std::pair<int, int>, uint32_t> swapTable;
+    // Área de swap: {PID, PáginaVirtual} -> EndereçoNoDisco
+    std::unique_ptr<SwapSpace> swap;
 
-    uint32_t nextSwapAddress;
+    // Imagens compartilhadas por program_path (com allocMutex)
+    std::unordered_map<std::string, std::unique_ptr<SharedImage>> images;
+    int nextImageKey = -1;
 
-    // Ponteiro para algoritmo FIFO/Clock
-    int victimFramePtr;
+    // Escolha da vítima (FIFO, Clock, Aging ou WSClock); lê os bits R/D por frameBits
+    std::unique_ptr<PageReplacer> replacer;
+    // Relógio de acessos: avança uma unidade por tradução (tempo do WSClock)
+    std::atomic<uint64_t> accessClock{0};
 
     // Métodos da MMU
-    uint32_t translateAddress(uint32_t virtualAddress, PCB& process, bool isWrite);
-    int allocateFrame(PCB& process, int virtualPage);
-
-    // Remove uma página da RAM para o Disco (retorna o índice do frame liberado)
-    int swapOut();
+    // Traduz o endereço e devolve com o frame correspondente travado em frameLock
+    // (canBlock: a falta pode ficar pendente, ver startPageIn)
+    uint32_t lockTranslation(uint32_t virtualAddress, PCB& process, bool isWrite, TLB* tlb, bool canBlock,
+                             std::unique_lock<std::mutex>& frameLock);
+    // Página -> frame pela tabela de páginas; -1 se a página não estiver na RAM
+    int lookupPage(PCB& process, int virtualPage);
+    // Percurso da MMU: como lookupPage, e devolve também a PTE (para o TLB e
+    // para os bits R/D)
+    int walkPage(PCB& process, int virtualPage, PageTable::Entry*& pte);
+    // Bits REFERENCED / DIRTY das PTEs que mapeiam o frame (numa página de
+    // imagem, o OU entre os processos que a usam), desligando os de clear.
+    // Chamados com allocMutex travado
+    uint8_t frameBits(size_t frame, uint8_t clear);
+    uint8_t pageBits(PCB& process, int virtualPage, size_t frame, uint8_t clear);
+    // O frame guarda esta página do processo (própria ou da imagem dele)
+    static bool frameHolds(const FrameInfo& owner, const PCB& process, int virtualPage);
+    // Passa o acesso ao prefetcher do núcleo e traz as linhas sugeridas que
+    // já estão na RAM. Chamado sem nenhuma trava.
+    void prefetchAfter(uint32_t virtualAddress, uint32_t pc, PCB& process, CorePort* port);
+    // Traz a página para a RAM (do disco ou nova); -1 se for leitura de página
+    // inexistente, PAGE_PENDING se canBlock e a falta ficou para o dispositivo
+    int handlePageFault(PCB& process, int virtualPage, bool isWrite, bool canBlock);
+
+    // De onde vem uma página fora da tabela do processo: a cópia própria no
+    // disco ou, se não houver, a imagem compartilhada (image != nullptr)
+    struct PageSource {
+        uint32_t diskAddress = SwapSpace::NO_SLOT;
+        SharedImage* image = nullptr;
+    };
+    // Os três chamados com allocMutex travado
+    PageSource locatePage(PCB& process, int virtualPage);
+    // Frame da página da imagem já na RAM (só falta mapear), ou -1
+    int residentImageFrame(const PageSource& source, int virtualPage);
+    // Frame para a página, já com o conteúdo e mapeado no processo
+    int loadPage(PCB& process, int virtualPage, const PageSource& source, bool coreWaits);
+    // Tabela de páginas + RSS; chamados com allocMutex travado.
+    // writable = false: página só de leitura (imagem compartilhada);
+    // dirty: o conteúdo não tem cópia no disco
+    void mapPage(PCB& process, int virtualPage, int frame, bool writable, bool dirty = false);
+    // Tira a página da tabela (se ainda apontar para frame) e dos TLBs
+    bool unmapPage(PCB& process, int virtualPage, int frame);
+    // Escrita numa página da imagem: o processo passa a ter uma cópia própria.
+    // -1 se não houver frame para a cópia, PAGE_PENDING se canBlock e a cópia
+    // ficou para o dispositivo; senão 0 (a tradução é refeita)
+    int copyOnWrite(PCB& process, int virtualPage, bool canBlock);
+    // Faz a cópia da página mapeada no frame shared da imagem; chamado com
+    // allocMutex travado. false se não houver frame (a página fica como estava)
+    bool copyImagePage(PCB& process, int virtualPage, int shared, bool coreWaits);
+    // requester: processo que espera o frame (paga a escrita no disco)
+    int allocateFrame(PCB& requester, bool coreWaits);
+    // Sem frame livre: o próximo frame custa um swapOut
+    bool needsVictim() const { return freeFrames.empty() && nextUnusedFrame >= numFrames; }
+    void recordResident();
+    // Cobra de payer a transferência de uma página de/para o disco. coreWaits:
+    // o núcleo ficou parado esperando (entra em memory_cycles); senão o
+    // processo esperou bloqueado e só disk_cycles conta
+    void chargeDisk(PCB& payer, uint32_t diskAddress, bool isWrite, bool coreWaits);
+
+    // Remove uma página da RAM para o Disco (retorna o índice do frame liberado,
+    // ou -1 se o disco estiver cheio)
+    int swapOut(PCB& requester, bool coreWaits);
 
     // Traz uma página do Disco para a RAM
-    void swapIn(int frameIndex, PCB& process, int virtualPage, uint32_t diskAddress);
+    void swapIn(int frameIndex, PCB& process, int virtualPage, uint32_t diskAddress, bool coreWaits);
+
+    // Dispositivo de paginação: atende as faltas pendentes em ordem de chegada
+    void pagingLoop();
+    std::mutex pagingMutex;
+    std::condition_variable pagingReady;
+    std::deque<PCB*> pagingQueue;
+    bool pagingStop = false;
+    std::thread pagingThread;   // só existe com memory.paging.async
 };
 
 #endif 
\ No newline at end of file
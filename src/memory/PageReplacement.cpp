@@ -0,0 +1,97 @@
+#include "PageReplacement.hpp"
+#include <algorithm>
+#include <utility>
+
+PageReplacer::PageReplacer(const PagingConfig &config, size_t frames, FrameBits frameBits)
+    : cfg(config), frames(frames), frameBits(std::move(frameBits)), lastUse(frames), age(frames), loadNumber(frames) {
+}
+
+void PageReplacer::onLoad(size_t frame, uint64_t now) {
+    // Página recém-carregada conta como usada agora
+    lastUse[frame] = now;
+    age[frame] = 0x80;
+    if (cfg.policy == PageReplacementPolicy::FIFO) {
+        loadNumber[frame] = ++loads;
+        loadOrder.emplace_back(frame, loads);
+        // Sem trocas as entradas vencidas não saem pela frente da fila
+        if (loadOrder.size() > 2 * frames) {
+            loadOrder.erase(std::remove_if(loadOrder.begin(), loadOrder.end(),
+                                           [this](const auto &entry) { return entry.second != loadNumber[entry.first]; }),
+                            loadOrder.end());
+        }
+    }
+}
+
+void PageReplacer::onRelease(size_t frame) {
+    age[frame] = 0;
+    loadNumber[frame] = 0;
+}
+
+size_t PageReplacer::selectVictim(uint64_t now) {
+    switch (cfg.policy) {
+        case PageReplacementPolicy::Clock:
+            return clockVictim();
+        case PageReplacementPolicy::Aging:
+            return agingVictim();
+        case PageReplacementPolicy::WSClock:
+            return wsclockVictim(now);
+        case PageReplacementPolicy::FIFO:
+            break;
+    }
+    // A entrada da vítima fica na fila: ela só vence quando o frame for
+    // carregado de novo (se o swapOut falhar, o frame continua o mais antigo)
+    while (!loadOrder.empty() && loadOrder.front().second != loadNumber[loadOrder.front().first]) {
+        loadOrder.pop_front();
+    }
+    return loadOrder.empty() ? 0 : loadOrder.front().first;
+}
+
+size_t PageReplacer::clockVictim() {
+    // Volta 1: (R=0, D=0) sem mexer nos bits. Volta 2: R=0 limpando R pelo caminho.
+    // Depois da volta 2 todo R está limpo, então a volta 3 sempre encontra a vítima.
+    for (size_t i = 0; i < frames; ++i) {
+        size_t f = (hand + i) % frames;
+        if ((frameBits(f, 0) & (PageTable::REFERENCED | PageTable::DIRTY)) == 0) {
+            hand = (f + 1) % frames;
+            return f;
+        }
+    }
+    for (size_t i = 0; i < 2 * frames; ++i) {
+        size_t f = hand;
+        hand = (hand + 1) % frames;
+        if (!takeReference(f)) return f;
+    }
+    return hand;
+}
+
+size_t PageReplacer::agingVictim() {
+    size_t victim = 0;
+    for (size_t f = 0; f < frames; ++f) {
+        age[f] = static_cast<uint8_t>((age[f] >> 1) | (takeReference(f) ? 0x80 : 0));
+        if (age[f] < age[victim]) victim = f;
+    }
+    return victim;
+}
+
+size_t PageReplacer::wsclockVictim(uint64_t now) {
+    size_t firstDirtyOld = frames;
+    size_t oldest = hand;
+    for (size_t i = 0; i < frames; ++i) {
+        size_t f = (hand + i) % frames;
+        if (takeReference(f)) {
+            lastUse[f] = now;
+            continue;
+        }
+        uint64_t used = lastUse[f];
+        if (used < lastUse[oldest]) oldest = f;
+        if (now - used <= cfg.workingSetWindow) continue;   // ainda no working set
+        if (!isDirty(f)) {
+            hand = (f + 1) % frames;
+            return f;
+        }
+        if (firstDirtyOld == frames) firstDirtyOld = f;
+    }
+    size_t victim = firstDirtyOld != frames ? firstDirtyOld : oldest;
+    hand = (victim + 1) % frames;
+    return victim;
+}
@@ -0,0 +1,80 @@
+#ifndef PAGE_REPLACEMENT_HPP
+#define PAGE_REPLACEMENT_HPP
+/*
+  PageReplacement.hpp
+  Escolha do frame vítima quando a RAM está cheia (MemoryManager::swapOut).
+
+  Os bits de referência (R) e de sujeira (D) são os das PTEs que mapeiam o
+  frame, ligados pela MMU a cada acesso (lockTranslation); o replacer os lê e
+  limpa por frameBits, que o MemoryManager fornece (numa página de imagem
+  compartilhada, o OU das PTEs de todos os processos). O instante do último
+  uso é medido no relógio de acessos do MemoryManager (uma unidade por
+  tradução) e anotado quando a carga ou a varredura encontra o frame usado.
+
+  - FIFO:    fila na ordem de carga; sai o frame carregado há mais tempo
+             (os frames liberados voltam fora de ordem, então a posição do
+             frame na RAM não diz nada).
+  - Clock:   segunda chance com classes (R, D): o ponteiro limpa R dos
+             frames referenciados e prefere um frame limpo não referenciado;
+             sem nenhum, o primeiro não referenciado.
+  - Aging:   aproximação de LRU: a cada troca, o contador de 8 bits de cada
+             frame desloca para a direita e recebe R no bit mais alto;
+             sai o de menor contador.
+  - WSClock: o ponteiro dá segunda chance aos referenciados (anotando o
+             instante) e tira um frame limpo fora do working set (sem uso
+             há mais de window acessos); sem limpo, o primeiro sujo fora do
+             working set; sem nenhum fora, o de uso mais antigo.
+
+  Todo o estado daqui só é usado com allocMutex (a varredura trava as
+  tabelas de páginas só para ler as PTEs). As tabelas por frame são esparsas
+  (SparseArray), então uma RAM grande só custa no hospedeiro os frames já
+  usados.
+*/
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <utility>
+#include "PageTable.hpp"
+#include "SparseArray.hpp"
+#include "../config/SimConfig.hpp"
+
+class PageReplacer {
+public:
+    // Bits REFERENCED / DIRTY das PTEs que mapeiam o frame; os bits de clear
+    // são desligados nelas depois da leitura
+    using FrameBits = std::function<uint8_t(size_t frame, uint8_t clear)>;
+
+    PageReplacer(const PagingConfig &config, size_t frames, FrameBits frameBits);
+
+    // Página nova no frame
+    void onLoad(size_t frame, uint64_t now);
+    // Frame devolvido à lista livre (o dono terminou)
+    void onRelease(size_t frame);
+    // Frame que sai (todos os frames ocupados)
+    size_t selectVictim(uint64_t now);
+
+    PageReplacementPolicy policy() const { return cfg.policy; }
+
+private:
+    size_t clockVictim();
+    size_t agingVictim();
+    size_t wsclockVictim(uint64_t now);
+    bool takeReference(size_t frame) { return (frameBits(frame, PageTable::REFERENCED) & PageTable::REFERENCED) != 0; }
+    bool isDirty(size_t frame) { return (frameBits(frame, 0) & PageTable::DIRTY) != 0; }
+
+    PagingConfig cfg;
+    size_t frames;
+    FrameBits frameBits;
+    size_t hand = 0;
+
+    SparseArray<uint64_t> lastUse;   // WSClock
+    SparseArray<uint8_t> age;        // Aging
+    // FIFO: (frame, número da carga). Uma entrada vale enquanto o frame não
+    // for liberado nem recarregado (loadNumber igual)
+    std::deque<std::pair<size_t, uint64_t>> loadOrder;
+    SparseArray<uint64_t> loadNumber;
+    uint64_t loads = 0;
+};
+
+#endif
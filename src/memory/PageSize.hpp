@@ -0,0 +1,16 @@
+#ifndef PAGE_SIZE_HPP
+#define PAGE_SIZE_HPP
+/*
+  PageSize.hpp
+  Limites do tamanho de página, usados pelo MemoryManager (páginas) e pelas
+  caches (a linha nunca passa da maior página).
+*/
+#include <cstddef>
+
+// Tamanho padrão da página em bytes (memory.page_size no batch.json muda).
+// A página pode ir de MIN_PAGE_SIZE a MAX_PAGE_SIZE, sempre em potência de 2.
+const size_t PAGE_SIZE = 32;
+const size_t MIN_PAGE_SIZE = 16;
+const size_t MAX_PAGE_SIZE = 4096;
+
+#endif
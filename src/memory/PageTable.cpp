@@ -0,0 +1,38 @@
+#include "PageTable.hpp"
+
+void PageTable::map(uint32_t virtualPage, uint32_t frame, bool writable, bool dirty) {
+    size_t dir = virtualPage >> LEAF_BITS;
+    if (dir >= directory.size()) directory.resize(dir + 1);
+    if (!directory[dir]) directory[dir] = std::make_unique<Entry[]>(LEAF_SIZE);
+
+    Entry& entry = directory[dir][virtualPage & (LEAF_SIZE - 1)];
+    if (!entry.has(VALID)) ++validCount;
+    entry.frame = frame;
+    entry.flags.store(VALID | (writable ? WRITABLE : 0) | (dirty ? DIRTY : 0), std::memory_order_relaxed);
+}
+
+bool PageTable::unmap(uint32_t virtualPage, uint32_t frame) {
+    Entry* entry = find(virtualPage);
+    if (entry == nullptr || entry->frame != frame) return false;
+    entry->flags.store(0, std::memory_order_relaxed);
+    --validCount;
+    return true;
+}
+
+void PageTable::clear() {
+    directory.clear();
+    validCount = 0;
+}
+
+std::vector<std::pair<int, int>> PageTable::entries() const {
+    std::vector<std::pair<int, int>> pages;
+    pages.reserve(validCount);
+    for (size_t dir = 0; dir < directory.size(); ++dir) {
+        if (!directory[dir]) continue;
+        for (size_t i = 0; i < LEAF_SIZE; ++i) {
+            const Entry& entry = directory[dir][i];
+            if (entry.has(VALID)) pages.emplace_back(static_cast<int>((dir << LEAF_BITS) | i), static_cast<int>(entry.frame));
+        }
+    }
+    return pages;
+}
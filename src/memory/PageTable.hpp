@@ -0,0 +1,80 @@
+#ifndef PAGE_TABLE_HPP
+#define PAGE_TABLE_HPP
+/*
+  PageTable.hpp
+  Tabela de páginas de dois níveis de um processo.
+
+  A página virtual se divide em índice do diretório (bits altos) e índice na
+  folha (LEAF_BITS baixos). O diretório cresce até a maior página usada e
+  cada folha é um vetor contíguo de LEAF_SIZE PTEs, criado na primeira página
+  mapeada dentro dele; uma folha nunca muda de lugar antes de clear().
+
+  Cada PTE leva o frame e os bits:
+  - VALID: a página está na RAM (o frame vale);
+  - WRITABLE: proteção; página de imagem compartilhada é só de leitura e a
+    escrita vira copy-on-write;
+  - REFERENCED / DIRTY: ligados pela MMU a cada acesso (a entrada do TLB
+    aponta para a PTE, como o hardware que grava os bits de volta nela). A
+    substituição de páginas lê e limpa REFERENCED, e DIRTY decide se a página
+    que sai é escrita no disco; página sem cópia no disco já entra suja.
+
+  Não tem trava própria: PCB::pageTableMutex protege a estrutura (map/unmap
+  com a trava exclusiva, o percurso com a compartilhada); os bits são
+  atômicos porque a MMU os liga pela PTE guardada no TLB, sem a trava.
+*/
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+class PageTable {
+public:
+    static constexpr unsigned LEVELS = 2;
+    static constexpr unsigned LEAF_BITS = 10;
+    static constexpr size_t LEAF_SIZE = size_t(1) << LEAF_BITS;
+
+    enum Flags : uint8_t {
+        VALID = 1,
+        WRITABLE = 2,
+        REFERENCED = 4,
+        DIRTY = 8
+    };
+
+    struct Entry {
+        uint32_t frame = 0;
+        std::atomic<uint8_t> flags{0};
+
+        bool has(uint8_t flag) const { return (flags.load(std::memory_order_relaxed) & flag) != 0; }
+        // Só escreve se faltar algum bit: núcleos que leem a página não disputam a linha
+        void set(uint8_t flag) {
+            if ((flags.load(std::memory_order_relaxed) & flag) != flag) flags.fetch_or(flag, std::memory_order_relaxed);
+        }
+    };
+
+    // PTE válida da página, ou nullptr (não cria folha)
+    Entry* find(uint32_t virtualPage) {
+        size_t dir = virtualPage >> LEAF_BITS;
+        if (dir >= directory.size() || !directory[dir]) return nullptr;
+        Entry& entry = directory[dir][virtualPage & (LEAF_SIZE - 1)];
+        return entry.has(VALID) ? &entry : nullptr;
+    }
+
+    // Página -> frame, com REFERENCED zerado e DIRTY = dirty
+    void map(uint32_t virtualPage, uint32_t frame, bool writable, bool dirty = false);
+    // Invalida a página se ela ainda apontar para frame
+    bool unmap(uint32_t virtualPage, uint32_t frame);
+    void clear();
+
+    // Páginas válidas agora
+    size_t size() const { return validCount; }
+    // (página, frame) de todas as páginas válidas
+    std::vector<std::pair<int, int>> entries() const;
+
+private:
+    std::vector<std::unique_ptr<Entry[]>> directory;
+    size_t validCount = 0;
+};
+
+#endif
@@ -0,0 +1,102 @@
+#include "Prefetcher.hpp"
+#include <cstdlib>
+
+// Distância máxima (em linhas) para um acesso continuar um fluxo
+static constexpr int64_t STREAM_WINDOW = 4;
+// Confiança mínima para pedir linhas (contadores saturam em 3)
+static constexpr uint8_t STRIDE_THRESHOLD = 2;
+static constexpr uint8_t STREAM_THRESHOLD = 1;
+
+Prefetcher::Prefetcher(const PrefetchConfig &config, size_t lineSize) : cfg(config), lineSize(lineSize) {
+    if (cfg.degree == 0) cfg.degree = 1;
+    if (cfg.tableEntries == 0) cfg.tableEntries = 1;
+    if (cfg.type == PrefetcherType::Stride) strideTable.resize(cfg.tableEntries);
+    if (cfg.type == PrefetcherType::Stream) streams.resize(cfg.tableEntries);
+    candidates.reserve(cfg.degree);
+}
+
+const std::vector<uint32_t> &Prefetcher::onAccess(uint32_t pc, uint32_t address) {
+    candidates.clear();
+    int64_t line = address / lineSize;
+    switch (cfg.type) {
+        case PrefetcherType::None:
+            break;
+        case PrefetcherType::NextLine:
+            nextLine(line);
+            break;
+        case PrefetcherType::Stride:
+            stride(pc, address);
+            break;
+        case PrefetcherType::Stream:
+            stream(line);
+            break;
+    }
+    lastLine = line;
+    return candidates;
+}
+
+void Prefetcher::request(int64_t line) {
+    if (line < 0 || line * static_cast<int64_t>(lineSize) > UINT32_MAX) return;
+    uint32_t address = static_cast<uint32_t>(line * lineSize);
+    if (!candidates.empty() && candidates.back() == address) return;
+    candidates.push_back(address);
+}
+
+void Prefetcher::nextLine(int64_t line) {
+    if (line == lastLine) return;
+    for (unsigned i = 0; i < cfg.degree; ++i) request(line + cfg.distance + i);
+}
+
+void Prefetcher::stride(uint32_t pc, uint32_t address) {
+    StrideEntry &entry = strideTable[(pc / 4) % strideTable.size()];
+    if (!entry.valid || entry.pc != pc) {
+        entry = StrideEntry{true, pc, address, 0, 0};
+        return;
+    }
+
+    int32_t step = static_cast<int32_t>(address - entry.lastAddress);
+    if (step == 0) return;
+    if (step == entry.stride) {
+        if (entry.confidence < 3) entry.confidence++;
+    } else {
+        if (entry.confidence > 0) entry.confidence--;
+        if (entry.confidence == 0) entry.stride = step;
+    }
+    entry.lastAddress = address;
+
+    if (entry.confidence < STRIDE_THRESHOLD) return;
+    for (unsigned i = 0; i < cfg.degree; ++i) {
+        int64_t target = static_cast<int64_t>(address) + static_cast<int64_t>(entry.stride) * (cfg.distance + i);
+        request(target / static_cast<int64_t>(lineSize));
+    }
+}
+
+void Prefetcher::stream(int64_t line) {
+    ++clock;
+    Stream *match = nullptr;
+    Stream *victim = &streams[0];
+    for (Stream &s : streams) {
+        if (s.valid && std::llabs(line - s.lastLine) <= STREAM_WINDOW) { match = &s; break; }
+        if (!s.valid || (victim->valid && s.lastUse < victim->lastUse)) victim = &s;
+    }
+
+    if (match == nullptr) {
+        *victim = Stream{true, line, 0, 0, clock};
+        return;
+    }
+    match->lastUse = clock;
+    if (line == match->lastLine) return;
+
+    int direction = line > match->lastLine ? 1 : -1;
+    if (direction == match->direction) {
+        if (match->confidence < 3) match->confidence++;
+    } else {
+        // Primeiro passo numa direção só a registra: o pedido espera o segundo
+        match->direction = direction;
+        match->confidence = 0;
+    }
+    match->lastLine = line;
+
+    if (match->confidence < STREAM_THRESHOLD) return;
+    for (unsigned i = 0; i < cfg.degree; ++i) request(line + direction * static_cast<int64_t>(cfg.distance + i));
+}
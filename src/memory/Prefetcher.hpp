@@ -0,0 +1,67 @@
+#ifndef PREFETCHER_HPP
+#define PREFETCHER_HPP
+/*
+  Prefetcher.hpp
+  Prefetcher de dados de um núcleo, ligado à L1D. Observa os acessos de
+  demanda (PC da instrução e endereço virtual) e sugere linhas para trazer
+  antes de serem pedidas. Trabalha com endereços virtuais porque as páginas
+  são menores que uma sequência típica de linhas; o MemoryManager traduz as
+  sugestões sem provocar page fault e descarta as que não estão na RAM.
+
+  - next_line: ao passar para uma linha nova, pede as degree linhas a partir
+    de distance linhas à frente.
+  - stride: tabela indexada pelo PC (tabela de referência): quando o mesmo
+    LW/SW repete o passo duas vezes, pede endereço + passo * (distance + i).
+  - stream: acompanha table_entries fluxos de linhas próximas; quando um
+    fluxo avança de novo na mesma direção, pede as linhas seguintes.
+
+  Só o núcleo dono usa o prefetcher, então ele não tem trava.
+*/
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../config/SimConfig.hpp"
+
+class Prefetcher {
+public:
+    Prefetcher(const PrefetchConfig &config, size_t lineSize);
+
+    bool enabled() const { return cfg.type != PrefetcherType::None; }
+
+    // Acesso de demanda; devolve os endereços virtuais a trazer (válidos até a próxima chamada)
+    const std::vector<uint32_t> &onAccess(uint32_t pc, uint32_t address);
+
+private:
+    struct StrideEntry {
+        bool valid = false;
+        uint32_t pc = 0;
+        uint32_t lastAddress = 0;
+        int32_t stride = 0;
+        uint8_t confidence = 0;
+    };
+
+    struct Stream {
+        bool valid = false;
+        int64_t lastLine = 0;
+        int direction = 0;
+        uint8_t confidence = 0;
+        uint64_t lastUse = 0;
+    };
+
+    void nextLine(int64_t line);
+    void stride(uint32_t pc, uint32_t address);
+    void stream(int64_t line);
+    // Acrescenta a linha às sugestões (sem repetir a última nem sair do espaço de 32 bits)
+    void request(int64_t line);
+
+    PrefetchConfig cfg;
+    size_t lineSize;
+    int64_t lastLine = -1;
+    uint64_t clock = 0;
+
+    std::vector<StrideEntry> strideTable;
+    std::vector<Stream> streams;
+    std::vector<uint32_t> candidates;
+};
+
+#endif
@@ -1,64 +1,123 @@
 #include "SECONDARY_MEMORY.hpp"
+#include <algorithm>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
-SECONDARY_MEMORY::SECONDARY_MEMORY(size_t size) {
-    if (size > MAX_SECONDARY_MEMORY_SIZE) {
+SECONDARY_MEMORY::SECONDARY_MEMORY(size_t size, const DiskConfig &config) : config(config) {
+    if (this->config.trackWords == 0) this->config.trackWords = 1;
+    if (this->config.sizeWords != 0) size = this->config.sizeWords;
+
+    // Endereços do disco são de 32 bits
+    this->size = std::min<size_t>(size, UINT32_MAX);
+    if (!this->config.image.empty() && mapImage(this->config.image)) return;
+
+    if (this->size > MAX_SECONDARY_MEMORY_SIZE) {
         this->size = MAX_SECONDARY_MEMORY_SIZE;
-    } else {
-        this->size = size;
     }
-    this->storage.resize(this->size, MEMORY_ACCESS_ERROR);
+    this->storage.resize(this->size, ~MEMORY_ACCESS_ERROR);
+    this->words = this->storage.data();
 }
 
 SECONDARY_MEMORY::~SECONDARY_MEMORY() {
+    if (mappedBytes != 0) {
+        munmap(words, mappedBytes);
+    }
     this->storage.clear();
 }
 
-// Simulação de acesso lento
+bool SECONDARY_MEMORY::mapImage(const std::string &path) {
+    int fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        std::cerr << "[DISCO] Nao foi possivel abrir a imagem " << path << " (usando memoria)\n";
+        return false;
+    }
+
+    // Arquivo menor que o disco cresce sem gravar nada (esparso); maior é usado só até size
+    size_t bytes = size * sizeof(uint32_t);
+    struct stat st;
+    bool ok = bytes > 0 && fstat(fd, &st) == 0 &&
+              (static_cast<size_t>(st.st_size) >= bytes || ftruncate(fd, static_cast<off_t>(bytes)) == 0);
+    void *mapped = ok ? mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    // O mapeamento continua valendo sem o descritor
+    close(fd);
+
+    if (mapped == MAP_FAILED) {
+        std::cerr << "[DISCO] Nao foi possivel mapear a imagem " << path << " (usando memoria)\n";
+        return false;
+    }
+    words = static_cast<uint32_t *>(mapped);
+    mappedBytes = bytes;
+    return true;
+}
+
 uint32_t SECONDARY_MEMORY::ReadMem(uint32_t address) {
     if (address < this->size) {
-        // Varredura simulada: percorre o vetor para encontrar o endereço
-        for (uint32_t i = 0; i < this->size; ++i) {
-            if (i == address) {
-                return storage[i];
-            }
-        }
+        return ~words[address];
     }
     return MEMORY_ACCESS_ERROR;
 }
 
-// Simulação de acesso lento
 uint32_t SECONDARY_MEMORY::WriteMem(uint32_t address, uint32_t data) {
     if (address < this->size) {
-        // Varredura simulada: percorre o vetor para encontrar o endereço
-        for (uint32_t i = 0; i < this->size; ++i) {
-            if (i == address) {
-                storage[i] = data;
-                return data;
-            }
-        }
+        words[address] = ~data;
+        return data;
     }
     return MEMORY_ACCESS_ERROR;
 }
 
+void SECONDARY_MEMORY::readBlock(uint32_t address, uint32_t *out, size_t count) {
+    size_t n = address < size ? std::min(count, size - address) : 0;
+    if (n > 0) std::transform(words + address, words + address + n, out, [](uint32_t w) { return ~w; });
+    std::fill_n(out + n, count - n, MEMORY_ACCESS_ERROR);
+}
+
+void SECONDARY_MEMORY::writeBlock(uint32_t address, const uint32_t *in, size_t count) {
+    size_t n = address < size ? std::min(count, size - address) : 0;
+    if (n > 0) std::transform(in, in + n, words + address, [](uint32_t w) { return ~w; });
+}
+
+uint64_t SECONDARY_MEMORY::transferLatency(uint32_t address, size_t words, bool isWrite) {
+    switch (config.type) {
+        case DiskType::Weighted:
+            return 0;
+        case DiskType::Flash:
+            return isWrite ? config.flashWriteLatency : config.flashReadLatency;
+        case DiskType::HDD:
+            break;
+    }
+
+    uint64_t cycles = static_cast<uint64_t>(words) * config.transferLatency;
+    size_t track = address / config.trackWords;
+    if (track != headTrack) cycles += config.seekLatency;
+    if (address != nextSequential) cycles += config.rotationalLatency;
+
+    nextSequential = address + words;
+    headTrack = (nextSequential - 1) / config.trackWords;
+    return cycles;
+}
+
 uint32_t SECONDARY_MEMORY::DeleteData(uint32_t address) {
     if (address < this->size) {
-        uint32_t deletedData = storage[address];
-        storage[address] = MEMORY_ACCESS_ERROR;
+        uint32_t deletedData = ~words[address];
+        words[address] = ~MEMORY_ACCESS_ERROR;
         return deletedData;
     }
     return MEMORY_ACCESS_ERROR;
 }
 
 bool SECONDARY_MEMORY::isEmpty() {
-    for (const auto &val : storage) {
-        if (val != MEMORY_ACCESS_ERROR) return false;
+    for (size_t i = 0; i < size; ++i) {
+        if (~words[i] != MEMORY_ACCESS_ERROR) return false;
     }
     return true;
 }
 
 bool SECONDARY_MEMORY::notFull() {
-    for (const auto &val : storage) {
-        if (val == MEMORY_ACCESS_ERROR) return true;
+    for (size_t i = 0; i < size; ++i) {
+        if (~words[i] == MEMORY_ACCESS_ERROR) return true;
     }
     return false;
 }
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include <cstdint>
 #include <vector>
 #include <cstddef>
+#include <string>
+#include "../config/SimConfig.hpp"
 
 #define MEMORY_ACCESS_ERROR UINT32_MAX
 #define MAX_SECONDARY_MEMORY_SIZE 8192
@@ -12,20 +14,67 @@ using std::size_t;
 using std::uint32_t;
 using std::vector;
 
+/*
+  Acesso ao conteúdo é direto (O(1)); a lentidão do disco é simulada por
+  transferLatency, que devolve os ciclos de uma transferência e quem pediu
+  a cobra no próprio relógio.
+
+  - hdd: seek se a transferência começa em outra trilha, latência
+    rotacional se ela não continua de onde a anterior parou, e um custo por
+    palavra. A cabeça fica onde a transferência terminou.
+  - flash: latência fixa por transferência (página), leitura mais rápida que
+    escrita.
+  - weighted: 0 aqui; o MemoryManager cobra o peso do processo.
+
+  O conteúdo fica num vetor do processo (até MAX_SECONDARY_MEMORY_SIZE
+  palavras) ou, com DiskConfig::image, num arquivo de imagem mapeado com
+  mmap. A imagem pode ter gigabytes: é criada esparsa e o sistema traz as
+  páginas do arquivo só quando são tocadas.
+
+  A imagem é espaço de trabalho da área de swap, não um disco persistente:
+  o índice do SwapSpace começa vazio a cada execução (e os lugares voltam
+  quando os processos terminam), então o que uma execução anterior deixou
+  no arquivo nunca é lido, só sobrescrito.
+
+  Nos dois casos cada palavra é guardada complementada (~palavra): o vetor
+  começa zerado e um trecho nunca escrito do arquivo esparso também lê
+  zero, então palavra nunca escrita vale MEMORY_ACCESS_ERROR, como na RAM.
+*/
 class SECONDARY_MEMORY {
 private:
     size_t size;
-    vector<uint32_t> storage; // Alterado para um vetor simples
+    vector<uint32_t> storage;   // sem imagem
+    uint32_t *words = nullptr;  // storage.data() ou a imagem mapeada (complementadas)
+    size_t mappedBytes = 0;     // 0 = sem imagem
+    DiskConfig config;
+
+    // Mapeia a imagem com size palavras; false se não der (fica no vetor)
+    bool mapImage(const std::string &path);
+
+    // Posição da cabeça (hdd)
+    size_t headTrack = 0;
+    size_t nextSequential = 0;
 
     bool notFull();
     bool isEmpty();
 
 public:
-    SECONDARY_MEMORY(size_t size);
+    SECONDARY_MEMORY(size_t size, const DiskConfig &config = DiskConfig{});
     ~SECONDARY_MEMORY();
+    SECONDARY_MEMORY(const SECONDARY_MEMORY &) = delete;
+    SECONDARY_MEMORY &operator=(const SECONDARY_MEMORY &) = delete;
     uint32_t ReadMem(uint32_t address);
     uint32_t WriteMem(uint32_t address, uint32_t data);
     uint32_t DeleteData(uint32_t address);
+    // Ciclos para transferir words palavras a partir de address (move a cabeça)
+    uint64_t transferLatency(uint32_t address, size_t words, bool isWrite);
+    // Cópias em bloco (direto no vetor ou na imagem). Palavras fora do disco
+    // não são copiadas; na leitura valem MEMORY_ACCESS_ERROR.
+    void readBlock(uint32_t address, uint32_t *out, size_t count);
+    void writeBlock(uint32_t address, const uint32_t *in, size_t count);
+    // Palavras endereçáveis
+    size_t capacity() const { return size; }
+    bool imageBacked() const { return mappedBytes != 0; }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,99 @@
+#ifndef SPARSE_ARRAY_HPP
+#define SPARSE_ARRAY_HPP
+/*
+  SparseArray.hpp
+  Vetor de tamanho fixo dividido em blocos de 2^ChunkBits elementos, criados
+  só no primeiro acesso. Serve para o que cresce com a memória física (a RAM
+  simulada e as tabelas por frame): uma região nunca tocada custa apenas um
+  ponteiro no diretório.
+
+  Os blocos não mudam de lugar nem são liberados antes do destrutor, então
+  referências a elementos continuam válidas. Criar um bloco é seguro entre
+  threads (o diretório é atômico); o acesso aos elementos segue as travas de
+  quem usa o vetor.
+*/
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+template <typename T, unsigned ChunkBits = 12>
+class SparseArray {
+public:
+    static constexpr size_t CHUNK = size_t(1) << ChunkBits;
+
+    // Elementos de blocos novos começam inicializados por valor (zero)
+    explicit SparseArray(size_t size)
+        : count(size), chunks((size + CHUNK - 1) / CHUNK),
+          directory(std::make_unique<std::atomic<T *>[]>(chunks)) {
+        for (size_t c = 0; c < chunks; ++c) directory[c].store(nullptr, std::memory_order_relaxed);
+    }
+
+    // Elementos de blocos novos começam com fill (e find devolve nullptr fora deles)
+    SparseArray(size_t size, const T &fill) : SparseArray(size) {
+        static_assert(std::is_copy_assignable<T>::value, "fill exige tipo copiável");
+        fillValue = fill;
+        hasFill = true;
+    }
+
+    ~SparseArray() {
+        for (size_t c = 0; c < chunks; ++c) delete[] directory[c].load(std::memory_order_relaxed);
+    }
+
+    SparseArray(const SparseArray &) = delete;
+    SparseArray &operator=(const SparseArray &) = delete;
+
+    size_t size() const { return count; }
+
+    // Elemento i, criando o bloco dele se preciso
+    T &operator[](size_t i) {
+        std::atomic<T *> &slot = directory[i >> ChunkBits];
+        T *chunk = slot.load(std::memory_order_acquire);
+        if (chunk == nullptr) chunk = allocate(slot);
+        return chunk[i & (CHUNK - 1)];
+    }
+
+    // Trecho contíguo [i, i + n) para cópia em bloco, criando o bloco se
+    // preciso; nullptr se o trecho cruzar a fronteira de um bloco
+    T *span(size_t i, size_t n) {
+        if (n == 0 || (i >> ChunkBits) != ((i + n - 1) >> ChunkBits)) return nullptr;
+        return &(*this)[i];
+    }
+
+    // Elemento i, ou nullptr se o bloco dele ainda não existir (não aloca)
+    const T *find(size_t i) const {
+        const T *chunk = directory[i >> ChunkBits].load(std::memory_order_acquire);
+        return chunk ? &chunk[i & (CHUNK - 1)] : nullptr;
+    }
+
+    // Blocos já criados (memória do hospedeiro em uso)
+    size_t chunksAllocated() const {
+        size_t n = 0;
+        for (size_t c = 0; c < chunks; ++c) n += directory[c].load(std::memory_order_relaxed) != nullptr;
+        return n;
+    }
+
+private:
+    T *allocate(std::atomic<T *> &slot) {
+        T *fresh = new T[CHUNK]();
+        if constexpr (std::is_copy_assignable<T>::value) {
+            if (hasFill) std::fill_n(fresh, CHUNK, fillValue);
+        }
+        // Duas threads podem criar o mesmo bloco: fica o primeiro
+        T *expected = nullptr;
+        if (slot.compare_exchange_strong(expected, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return fresh;
+        }
+        delete[] fresh;
+        return expected;
+    }
+
+    size_t count;
+    size_t chunks;
+    std::unique_ptr<std::atomic<T *>[]> directory;
+    T fillValue{};
+    bool hasFill = false;
+};
+
+#endif
@@ -0,0 +1,103 @@
+#include "SwapSpace.hpp"
+
+SwapSpace::SwapSpace(size_t slots, size_t wordsPerSlot) : slots(slots), wordsPerSlot(wordsPerSlot) {
+    bitmap.assign((slots + 63) / 64, 0);
+    // Lugares além do fim da última palavra ficam marcados como ocupados
+    if (slots % 64 != 0) bitmap.back() = ~0ULL << (slots % 64);
+
+    table.resize(64);
+    mask = table.size() - 1;
+}
+
+size_t SwapSpace::home(int pid, int page) const {
+    // Mistura de 64 bits (splitmix64) da chave (pid, página)
+    uint64_t x = (static_cast<uint64_t>(static_cast<uint32_t>(pid)) << 32) | static_cast<uint32_t>(page);
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return static_cast<size_t>(x) & mask;
+}
+
+long SwapSpace::findEntry(int pid, int page) const {
+    for (size_t pos = home(pid, page);; pos = (pos + 1) & mask) {
+        const Entry &e = table[pos];
+        if (e.slot == NO_SLOT) return -1;
+        if (e.pid == pid && e.page == page) return static_cast<long>(pos);
+    }
+}
+
+uint32_t SwapSpace::find(int pid, int page) const {
+    long pos = findEntry(pid, page);
+    return pos < 0 ? NO_SLOT : static_cast<uint32_t>(table[pos].slot * wordsPerSlot);
+}
+
+uint32_t SwapSpace::allocateSlot() {
+    for (size_t i = 0; i < bitmap.size(); ++i) {
+        size_t w = (cursor + i) % bitmap.size();
+        if (bitmap[w] == ~0ULL) continue;
+        unsigned bit = __builtin_ctzll(~bitmap[w]);
+        bitmap[w] |= 1ULL << bit;
+        cursor = w;
+        ++usedSlots;
+        return static_cast<uint32_t>(w * 64 + bit);
+    }
+    return NO_SLOT;
+}
+
+uint32_t SwapSpace::assign(int pid, int page) {
+    uint32_t slot = allocateSlot();
+    if (slot == NO_SLOT) return NO_SLOT;
+
+    // usedSlots já conta a entrada nova
+    if (usedSlots * 2 > table.size()) grow();
+    insert(Entry{pid, page, slot});
+    return static_cast<uint32_t>(slot * wordsPerSlot);
+}
+
+void SwapSpace::insert(const Entry &entry) {
+    size_t pos = home(entry.pid, entry.page);
+    while (table[pos].slot != NO_SLOT) pos = (pos + 1) & mask;
+    table[pos] = entry;
+}
+
+void SwapSpace::grow() {
+    std::vector<Entry> old(table.size() * 2);
+    old.swap(table);
+    mask = table.size() - 1;
+    for (const Entry &e : old) {
+        if (e.slot != NO_SLOT) insert(e);
+    }
+}
+
+void SwapSpace::eraseAt(size_t pos) {
+    uint32_t slot = table[pos].slot;
+    bitmap[slot / 64] &= ~(1ULL << (slot % 64));
+    --usedSlots;
+
+    // Remoção com deslocamento: cada entrada seguinte da sequência volta para
+    // o buraco se a posição de origem dela não estiver entre o buraco e ela
+    size_t hole = pos;
+    for (size_t next = (pos + 1) & mask; table[next].slot != NO_SLOT; next = (next + 1) & mask) {
+        size_t origin = home(table[next].pid, table[next].page);
+        bool stays = hole <= next ? (hole < origin && origin <= next) : (hole < origin || origin <= next);
+        if (stays) continue;
+        table[hole] = table[next];
+        hole = next;
+    }
+    table[hole] = Entry{};
+}
+
+void SwapSpace::release(int pid, int page) {
+    long pos = findEntry(pid, page);
+    if (pos >= 0) eraseAt(static_cast<size_t>(pos));
+}
+
+size_t SwapSpace::releaseProcess(int pid) {
+    std::vector<int> pages;
+    for (const Entry &e : table) {
+        if (e.slot != NO_SLOT && e.pid == pid) pages.push_back(e.page);
+    }
+    for (int page : pages) release(pid, page);
+    return pages.size();
+}
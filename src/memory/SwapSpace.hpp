@@ -0,0 +1,69 @@
+#ifndef SWAP_SPACE_HPP
+#define SWAP_SPACE_HPP
+/*
+  SwapSpace.hpp
+  Área de swap da memória secundária, dividida em lugares (slots) do tamanho
+  de uma página.
+
+  - Alocação: bitmap com um bit por lugar (1 = ocupado). A busca começa no
+    último lugar alocado e pula 64 lugares ocupados por vez, então os lugares
+    liberados são reaproveitados sem que a área cresça.
+  - Índice: tabela hash de endereçamento aberto (sondagem linear) de
+    (pid, página virtual) para o lugar. Dobra de tamanho quando passa de
+    metade cheia, então acompanha as páginas em swap e não o tamanho do
+    disco (que com uma imagem mapeada pode ter milhões de lugares); a
+    remoção desloca as entradas seguintes para trás e não deixa marcas de
+    apagado.
+
+  Não tem trava própria: o MemoryManager só usa com allocMutex.
+*/
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class SwapSpace {
+public:
+    static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+    // slots lugares de wordsPerSlot palavras, a partir do endereço 0 do disco
+    SwapSpace(size_t slots, size_t wordsPerSlot);
+
+    // Endereço (em palavras) da página no disco, ou NO_SLOT
+    uint32_t find(int pid, int page) const;
+    // Reserva um lugar para a página e devolve o endereço; NO_SLOT se o disco
+    // estiver cheio. A página não pode ter lugar ainda.
+    uint32_t assign(int pid, int page);
+    // Devolve o lugar da página (se houver)
+    void release(int pid, int page);
+    // Devolve todos os lugares do processo; retorna quantos eram
+    size_t releaseProcess(int pid);
+
+    size_t used() const { return usedSlots; }
+    size_t capacity() const { return slots; }
+
+private:
+    struct Entry {
+        int pid = 0;
+        int page = 0;
+        uint32_t slot = NO_SLOT;   // NO_SLOT = posição vazia
+    };
+
+    size_t home(int pid, int page) const;
+    // Posição da entrada da página na tabela, ou -1
+    long findEntry(int pid, int page) const;
+    void eraseAt(size_t pos);
+    void insert(const Entry &entry);
+    void grow();
+    uint32_t allocateSlot();
+
+    size_t slots;
+    size_t wordsPerSlot;
+    size_t usedSlots = 0;
+    size_t cursor = 0;               // palavra do bitmap onde a busca começa
+
+    std::vector<uint64_t> bitmap;
+    std::vector<Entry> table;        // tamanho em potência de 2
+    size_t mask;
+};
+
+#endif
@@ -0,0 +1,54 @@
+#include "TLB.hpp"
+
+TLB::TLB(const TLBConfig &config) {
+    if (config.entries == 0) return; // TLB desligado
+
+    ways = config.associativity;
+    if (ways == 0 || ways > config.entries) ways = config.entries; // 0 = totalmente associativo
+    sets = config.entries / ways;
+    entries.assign(sets * ways, Entry{});
+}
+
+TLB::Entry *TLB::find(int asid, uint32_t virtualPage) {
+    size_t base = setBase(virtualPage);
+    for (size_t i = base; i < base + ways; ++i) {
+        Entry &entry = entries[i];
+        if (entry.valid && entry.asid == asid && entry.virtualPage == virtualPage) return &entry;
+    }
+    return nullptr;
+}
+
+bool TLB::lookup(int asid, uint32_t virtualPage, uint32_t &frame, PageTable::Entry *&pte) {
+    if (!enabled()) return false;
+    std::lock_guard<std::mutex> lock(mutex);
+    Entry *entry = find(asid, virtualPage);
+    if (entry == nullptr) return false;
+    entry->lastUse = ++useClock;
+    frame = entry->frame;
+    pte = entry->pte;
+    return true;
+}
+
+void TLB::insert(int asid, uint32_t virtualPage, uint32_t frame, PageTable::Entry *pte) {
+    if (!enabled()) return;
+    std::lock_guard<std::mutex> lock(mutex);
+
+    Entry *victim = find(asid, virtualPage);
+    if (victim == nullptr) {
+        // Primeiro uma entrada livre; se não houver, a menos usada recentemente
+        size_t base = setBase(virtualPage);
+        victim = &entries[base];
+        for (size_t i = base; i < base + ways; ++i) {
+            Entry &entry = entries[i];
+            if (!entry.valid) { victim = &entry; break; }
+            if (entry.lastUse < victim->lastUse) victim = &entry;
+        }
+    }
+    *victim = Entry{asid, virtualPage, frame, ++useClock, pte, true};
+}
+
+void TLB::invalidate(int asid, uint32_t virtualPage) {
+    if (!enabled()) return;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (Entry *entry = find(asid, virtualPage)) entry->valid = false;
+}
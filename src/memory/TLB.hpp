@@ -0,0 +1,60 @@
+#ifndef TLB_HPP
+#define TLB_HPP
+/*
+  TLB.hpp
+  Translation lookaside buffer de um núcleo: guarda traduções recentes
+  página virtual -> frame físico, para que a maioria dos acessos não precise
+  consultar a tabela de páginas do processo.
+
+  As entradas são marcadas com o ASID (o PID do processo), então a troca de
+  contexto não precisa esvaziar o TLB. A organização é associativa por
+  conjunto (entries / associativity conjuntos), com substituição LRU dentro
+  do conjunto.
+
+  Quando o MemoryManager tira uma página da RAM (swapOut), ele derruba a
+  entrada correspondente em todos os TLBs (shootdown), senão um núcleo
+  continuaria acessando o frame que agora pertence a outra página. Como o
+  shootdown vem de outra thread, cada TLB tem a sua trava (só o núcleo dono
+  e os shootdowns disputam por ela).
+*/
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "PageTable.hpp"
+#include "../config/SimConfig.hpp"
+
+class TLB {
+public:
+    explicit TLB(const TLBConfig &config = TLBConfig{});
+
+    // Procura a tradução; em caso de acerto preenche frame e a PTE de onde ela
+    // veio (a MMU liga nela REFERENCED / DIRTY e confere a proteção)
+    bool lookup(int asid, uint32_t virtualPage, uint32_t &frame, PageTable::Entry *&pte);
+    // Grava a tradução obtida na tabela de páginas (substitui a LRU do conjunto)
+    void insert(int asid, uint32_t virtualPage, uint32_t frame, PageTable::Entry *pte);
+    // Shootdown de uma página
+    void invalidate(int asid, uint32_t virtualPage);
+
+    bool enabled() const { return !entries.empty(); }
+
+private:
+    struct Entry {
+        int asid = 0;
+        uint32_t virtualPage = 0;
+        uint32_t frame = 0;
+        uint64_t lastUse = 0;
+        PageTable::Entry *pte = nullptr;   // a folha não muda de lugar enquanto o processo existe
+        bool valid = false;
+    };
+
+    Entry *find(int asid, uint32_t virtualPage);
+    size_t setBase(uint32_t virtualPage) const { return (virtualPage % sets) * ways; }
+
+    std::mutex mutex;
+    std::vector<Entry> entries;
+    size_t sets = 0;
+    size_t ways = 0;
+    uint64_t useClock = 0;
+};
+
+#endif // TLB_HPP
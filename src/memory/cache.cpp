@@ -1,99 +1,134 @@
 #include "cache.hpp"
-#include "cachePolicy.hpp"
-#include "MemoryManager.hpp" // Necessário para a lógica de write-back
-
-Cache::Cache() {
-    this->capacity = CACHE_CAPACITY;
-    this->cacheMap.reserve(CACHE_CAPACITY);
-    this->cache_misses = 0;
-    this->cache_hits = 0;
+#include <algorithm>
+#include "PageSize.hpp"
+
+static size_t sanitizeLineSize(size_t lineSize) {
+    // Potência de 2 entre uma palavra e a maior página (o MemoryManager ainda
+    // limita à página em uso, para a linha nunca cruzar páginas)
+    size_t size = 4;
+    while (size * 2 <= lineSize && size * 2 <= MAX_PAGE_SIZE) size *= 2;
+    return size;
 }
 
-Cache::~Cache() {
-    this->cacheMap.clear();
+Cache::Cache(const CacheConfig &config) : cfg(config) {
+    cfg.lineSize = static_cast<unsigned>(sanitizeLineSize(cfg.lineSize));
+    if (cfg.sets == 0) cfg.sets = 1;
+    if (cfg.ways == 0) cfg.ways = 1;
+    wordsPerLine = cfg.lineSize / 4;
+
+    size_t lines = static_cast<size_t>(cfg.sets) * cfg.ways;
+    tags.assign(lines, 0);
+    states.assign(lines, LineState::Invalid);
+    data.assign(lines * wordsPerLine, 0);
+    prefetched.assign(lines, 0);
+    readyAt.assign(lines, 0);
+    policy = CachePolicy(cfg.policy, cfg.sets, cfg.ways);
+    setLocks = std::make_unique<std::mutex[]>(cfg.sets);
 }
 
-size_t Cache::get(size_t address) {
-    if (cacheMap.count(address) > 0 && cacheMap[address].isValid) {
-        cache_hits++;
-        return cacheMap[address].data; // Cache hit
-    }
+std::unique_lock<std::mutex> Cache::lockSet(size_t address) {
+    return std::unique_lock<std::mutex>(setLocks[setIndex(address)]);
+}
 
-    cache_misses++;
-    return CACHE_MISS; // Cache miss
+long Cache::findLine(size_t address) const {
+    size_t base = setIndex(address) * cfg.ways;
+    size_t tag = tagOf(address);
+    for (size_t slot = base; slot < base + cfg.ways; ++slot) {
+        if (states[slot] != LineState::Invalid && tags[slot] == tag) return static_cast<long>(slot);
+    }
+    return -1;
 }
 
-void Cache::put(size_t address, size_t data, MemoryManager* memManager) {
-    // Se a cache está cheia, precisamos remover um item
-    if (cacheMap.size() >= capacity) {
-        CachePolicy cachepolicy;
-        // A política de remoção nos dirá qual endereço remover
-        size_t addr_to_remove = cachepolicy.getAddressToReplace(fifo_queue);
-
-        if (addr_to_remove != -1) {
-            CacheEntry& entry_to_remove = cacheMap[addr_to_remove];
-
-            // Lógica de WRITE-BACK: se o bloco a ser removido estiver sujo...
-            if (entry_to_remove.isDirty) {
-                // ...escreve o dado de volta na memória usando o MemoryManager.
-                // Aqui passamos 'nullptr' para o PCB, pois a operação de write-back
-                // é do sistema de memória e não de um processo específico.
-                memManager->writeToFile(addr_to_remove, entry_to_remove.data);
-            }
-            // Remove da cache
-            cacheMap.erase(addr_to_remove);
-        }
+bool Cache::lookup(size_t address) {
+    long slot = findLine(address);
+    if (slot < 0) {
+        misses++;
+        return false;
     }
+    hits++;
+    policy.onHit(setIndex(address), static_cast<size_t>(slot) % cfg.ways);
+    return true;
+}
 
-    // Adiciona o novo item na cache
-    CacheEntry new_entry;
-    new_entry.data = data;
-    new_entry.isValid = true;
-    new_entry.isDirty = false; // Começa como "limpo"
+LineState Cache::state(size_t address) const {
+    long slot = findLine(address);
+    return slot < 0 ? LineState::Invalid : states[slot];
+}
 
-    cacheMap[address] = new_entry;
-    fifo_queue.push(address); // Adiciona na fila do FIFO
+void Cache::setState(size_t address, LineState state) {
+    long slot = findLine(address);
+    if (slot >= 0) states[slot] = state;
 }
 
-void Cache::update(size_t address, size_t data) {
-    // Se o item não está na cache, primeiro o colocamos lá
-    if (cacheMap.find(address) == cacheMap.end()) {
-        // Para a simplicidade, assumimos que o `put` deve ser chamado pelo `MemoryManager`
-        // em um cache miss de escrita. Aqui, focamos em atualizar.
-        // Em um sistema real, aqui ocorreria um "write-allocate".
-        // Por ora, vamos apenas atualizar se existir.
-        return;
-    }
-    
-    cacheMap[address].data = data;
-    cacheMap[address].isDirty = true; // Marca como sujo
-    cacheMap[address].isValid = true;
+uint32_t Cache::readWord(size_t address) const {
+    return data[wordIndex(findLine(address), address)];
 }
 
-void Cache::invalidate() {
-    for (auto &c : cacheMap) {
-        c.second.isValid = false;
-    }
-    // Limpar a fila FIFO também, pois a cache foi invalidada
-    std::queue<size_t> empty;
-    fifo_queue.swap(empty);
+void Cache::writeWord(size_t address, uint32_t value) {
+    long slot = findLine(address);
+    data[wordIndex(slot, address)] = value;
+    states[slot] = LineState::Modified;
+}
+
+void Cache::readLine(size_t address, uint32_t *words) const {
+    long slot = findLine(address);
+    std::copy_n(&data[slot * wordsPerLine], wordsPerLine, words);
+}
+
+void Cache::writeLine(size_t address, const uint32_t *words) {
+    long slot = findLine(address);
+    std::copy_n(words, wordsPerLine, &data[slot * wordsPerLine]);
 }
 
-std::vector<std::pair<size_t, size_t>> Cache::dirtyData() {
-    std::vector<std::pair<size_t, size_t>> dirty_data;
-    for (const auto &c : cacheMap) {
-        if (c.second.isDirty) {
-            dirty_data.emplace_back(c.first, c.second.data);
-        }
+bool Cache::install(size_t address, const uint32_t *words, LineState state, EvictedLine &evicted) {
+    size_t set = setIndex(address);
+    size_t base = set * cfg.ways;
+
+    // Primeiro uma via livre; se não houver, a que a política escolher
+    size_t way = cfg.ways;
+    for (size_t w = 0; w < cfg.ways; ++w) {
+        if (states[base + w] == LineState::Invalid) { way = w; break; }
+    }
+    bool replaced = false;
+    if (way == cfg.ways) {
+        way = policy.victim(set);
+        size_t slot = base + way;
+        // Endereço da linha que sai a partir da tag e do conjunto
+        evicted.address = (tags[slot] * cfg.sets + set) * cfg.lineSize;
+        evicted.state = states[slot];
+        evicted.prefetched = prefetched[slot] != 0;
+        evicted.words.assign(&data[slot * wordsPerLine], &data[slot * wordsPerLine] + wordsPerLine);
+        replaced = true;
     }
-    return dirty_data;
+
+    size_t slot = base + way;
+    std::copy_n(words, wordsPerLine, &data[slot * wordsPerLine]);
+    tags[slot] = tagOf(address);
+    states[slot] = state;
+    prefetched[slot] = 0;
+    policy.onFill(set, way);
+    return replaced;
+}
+
+LineState Cache::invalidate(size_t address) {
+    long slot = findLine(address);
+    if (slot < 0) return LineState::Invalid;
+    LineState previous = states[slot];
+    states[slot] = LineState::Invalid;
+    prefetched[slot] = 0;
+    return previous;
+}
+
+void Cache::markPrefetched(size_t address, uint64_t ready) {
+    long slot = findLine(address);
+    prefetched[slot] = 1;
+    readyAt[slot] = ready;
 }
 
-int Cache::get_misses(){
-       // Retorna o número de cache misses
-    return cache_misses;
+bool Cache::consumePrefetch(size_t address, uint64_t &ready) {
+    long slot = findLine(address);
+    if (slot < 0 || !prefetched[slot]) return false;
+    prefetched[slot] = 0;
+    ready = readyAt[slot];
+    return true;
 }
-int Cache::get_hits(){
-       // Retorna o número de cache hits
-    return cache_hits;
-}
\ No newline at end of file
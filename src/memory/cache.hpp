@@ -1,41 +1,106 @@
 #ifndef CACHE_HPP
 #define CACHE_HPP
+/*
+  cache.hpp
+  Um nível de cache associativo por conjunto, organizado em linhas.
 
+  A geometria vem da configuração (tamanho da linha, número de conjuntos e
+  de vias). Tags, estados e dados ficam em vetores contíguos: o conjunto s
+  ocupa as posições [s * ways, (s + 1) * ways) e a busca percorre só essas
+  vias, sem hash.
+
+  Cada linha guarda um estado MESI. Nas L1 privadas ele é o protocolo de
+  coerência; na L2 compartilhada só Shared (limpa) e Modified (suja em
+  relação à RAM) aparecem. Quem decide de onde vem uma linha e o que fazer
+  com a que sai é a CacheHierarchy; esta classe só guarda as linhas.
+
+  Cada conjunto tem a sua trava (lockSet), usada pelo núcleo dono da L1 no
+  caminho de acerto e pelos snoops dos outros núcleos.
+*/
+#include <atomic>
 #include <cstdint>
-#include <cstddef> 
-#include <unordered_map>
+#include <cstddef>
+#include <memory>
+#include <mutex>
 #include <vector>
-#include <queue> // Adicionado para FIFO
+#include "cachePolicy.hpp"
+#include "../config/SimConfig.hpp"
 
-#define CACHE_CAPACITY 16
-#define CACHE_MISS UINT32_MAX
+enum class LineState : uint8_t {
+    Invalid,
+    Shared,      // cópia limpa, pode haver outras
+    Exclusive,   // cópia limpa e única
+    Modified     // cópia suja e única
+};
 
-struct CacheEntry {
-    size_t data;
-    bool isValid;
-    bool isDirty;
+// Linha tirada da cache por install(): endereço, estado e conteúdo
+struct EvictedLine {
+    size_t address = 0;
+    LineState state = LineState::Invalid;
+    bool prefetched = false;   // trazida por prefetch e nunca usada
+    std::vector<uint32_t> words;
 };
-class MemoryManager;
 
 class Cache {
+public:
+    explicit Cache(const CacheConfig &config = CacheConfig{});
+
+    // Trava do conjunto que guarda o endereço
+    std::unique_lock<std::mutex> lockSet(size_t address);
+
+    // Acesso de um núcleo: conta acerto/miss e, no acerto, avisa a política
+    bool lookup(size_t address);
+    // Estado da linha do endereço (Invalid se ausente), sem contar acesso
+    LineState state(size_t address) const;
+    // As funções abaixo exigem a linha presente
+    void setState(size_t address, LineState state);
+    uint32_t readWord(size_t address) const;
+    void writeWord(size_t address, uint32_t value);
+    void readLine(size_t address, uint32_t *words) const;
+    void writeLine(size_t address, const uint32_t *words);
+
+    // Instala a linha (wordsPerLine palavras) no estado dado. Se uma linha
+    // válida sair para dar lugar a ela, retorna true e a descreve em evicted.
+    bool install(size_t address, const uint32_t *words, LineState state, EvictedLine &evicted);
+    // Descarta a linha; devolve o estado que ela tinha
+    LineState invalidate(size_t address);
+
+    // Linha presente trazida por prefetch, pronta no ciclo readyAt
+    void markPrefetched(size_t address, uint64_t readyAt);
+    // Primeiro uso de uma linha de prefetch: true (e o ciclo em que ela fica
+    // pronta) só se a linha veio por prefetch e ainda não tinha sido usada
+    bool consumePrefetch(size_t address, uint64_t &readyAt);
+
+    size_t lineBase(size_t address) const { return address - address % cfg.lineSize; }
+    size_t lineSize() const { return cfg.lineSize; }
+    size_t wordsInLine() const { return wordsPerLine; }
+    const CacheConfig &config() const { return cfg; }
+    uint64_t get_hits() const { return hits.load(); }
+    uint64_t get_misses() const { return misses.load(); }
+
 private:
-    std::unordered_map<size_t, CacheEntry> cacheMap;
-    std::queue<size_t> fifo_queue; // Fila para controlar a ordem de entrada (FIFO)
-    size_t capacity;
-    int cache_misses;
-    int cache_hits;
+    size_t setIndex(size_t address) const { return (address / cfg.lineSize) % cfg.sets; }
+    size_t tagOf(size_t address) const { return address / cfg.lineSize / cfg.sets; }
+    // Posição (conjunto * vias + via) da linha, ou -1 se ela não estiver na cache
+    long findLine(size_t address) const;
+    size_t wordIndex(size_t slot, size_t address) const {
+        return slot * wordsPerLine + (address % cfg.lineSize) / 4;
+    }
 
-public:
-    Cache();
-    ~Cache();
-    int get_misses();
-    int get_hits();
-    size_t get(size_t address);
-    // O método put agora precisa interagir com o MemoryManager para o write-back
-    void put(size_t address, size_t data, MemoryManager* memManager);
-    void update(size_t address, size_t data);
-    void invalidate();
-    std::vector<std::pair<size_t, size_t>> dirtyData(); // Mantido para possíveis outras lógicas
+    CacheConfig cfg;
+    size_t wordsPerLine;
+
+    std::vector<size_t> tags;
+    std::vector<LineState> states;
+    std::vector<uint32_t> data;   // wordsPerLine palavras por linha
+    std::vector<uint8_t> prefetched;
+    std::vector<uint64_t> readyAt;
+
+    CachePolicy policy;
+    std::unique_ptr<std::mutex[]> setLocks;
+
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
 };
 
-#endif
\ No newline at end of file
+#endif
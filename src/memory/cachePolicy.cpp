@@ -1,19 +1,134 @@
 #include "cachePolicy.hpp"
 
-CachePolicy::CachePolicy() {}
+CachePolicy::CachePolicy(ReplacementPolicy type, size_t sets, size_t ways) : policy(type), ways(ways) {
+    // PLRU precisa de uma árvore completa; com vias fora de potência de 2 vira LRU
+    if (policy == ReplacementPolicy::PLRU && (ways & (ways - 1)) != 0) policy = ReplacementPolicy::LRU;
 
-CachePolicy::~CachePolicy() {}
+    switch (policy) {
+        case ReplacementPolicy::FIFO:
+            nextVictim.assign(sets, 0);
+            break;
+        case ReplacementPolicy::LRU:
+            lastUse.assign(sets * ways, 0);
+            useClock.assign(sets, 0);
+            break;
+        case ReplacementPolicy::PLRU:
+            tree.assign(sets * (ways > 1 ? ways - 1 : 1), 0);
+            break;
+        case ReplacementPolicy::Random:
+        case ReplacementPolicy::SRRIP:
+        case ReplacementPolicy::BRRIP:
+            rng.resize(sets);
+            for (size_t s = 0; s < sets; ++s) rng[s] = static_cast<uint32_t>(s * 2654435761u) | 1u;
+            rrpv.assign(sets * ways, RRPV_MAX);
+            break;
+    }
+}
+
+uint32_t CachePolicy::nextRandom(size_t set) {
+    uint32_t x = rng[set];
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    rng[set] = x;
+    return x;
+}
 
-// Implementação da política FIFO
-size_t CachePolicy::getAddressToReplace(std::queue<size_t>& fifo_queue) {
-    if (fifo_queue.empty()) {
-        return -1; // Retorna -1 se não houver nada para remover
+// PLRU: cada nó aponta (bit 0 = esquerda, 1 = direita) para a metade a ser
+// substituída; um acesso faz os nós do caminho apontarem para a outra metade
+void CachePolicy::touchTree(size_t set, size_t way) {
+    uint8_t *bits = &tree[set * (ways - 1)];
+    size_t node = 0, low = 0, span = ways;
+    while (span > 1) {
+        span /= 2;
+        bool right = way >= low + span;
+        bits[node] = right ? 0 : 1;
+        node = 2 * node + (right ? 2 : 1);
+        if (right) low += span;
     }
+}
+
+size_t CachePolicy::victim(size_t set) {
+    if (ways == 1) return 0;
+    size_t base = set * ways;
+
+    switch (policy) {
+        case ReplacementPolicy::FIFO:
+            return nextVictim[set];
+
+        case ReplacementPolicy::LRU: {
+            size_t oldest = 0;
+            for (size_t w = 1; w < ways; ++w) {
+                if (lastUse[base + w] < lastUse[base + oldest]) oldest = w;
+            }
+            return oldest;
+        }
+
+        case ReplacementPolicy::PLRU: {
+            const uint8_t *bits = &tree[set * (ways - 1)];
+            size_t node = 0, low = 0, span = ways;
+            while (span > 1) {
+                span /= 2;
+                bool right = bits[node] != 0;
+                node = 2 * node + (right ? 2 : 1);
+                if (right) low += span;
+            }
+            return low;
+        }
 
-    // Pega o primeiro endereço que entrou na fila
-    size_t address_to_remove = fifo_queue.front();
-    // Remove da fila
-    fifo_queue.pop();
+        case ReplacementPolicy::Random:
+            return nextRandom(set) % ways;
 
-    return address_to_remove;
-}
\ No newline at end of file
+        case ReplacementPolicy::SRRIP:
+        case ReplacementPolicy::BRRIP:
+            // Envelhece o conjunto até alguma linha chegar ao RRPV máximo
+            while (true) {
+                for (size_t w = 0; w < ways; ++w) {
+                    if (rrpv[base + w] == RRPV_MAX) return w;
+                }
+                for (size_t w = 0; w < ways; ++w) rrpv[base + w]++;
+            }
+    }
+    return 0;
+}
+
+void CachePolicy::onFill(size_t set, size_t way) {
+    switch (policy) {
+        case ReplacementPolicy::FIFO:
+            // A linha mais antiga do conjunto é a seguinte à que acabou de entrar
+            nextVictim[set] = (way + 1) % ways;
+            break;
+        case ReplacementPolicy::LRU:
+            lastUse[set * ways + way] = ++useClock[set];
+            break;
+        case ReplacementPolicy::PLRU:
+            if (ways > 1) touchTree(set, way);
+            break;
+        case ReplacementPolicy::Random:
+            break;
+        case ReplacementPolicy::SRRIP:
+            rrpv[set * ways + way] = RRPV_MAX - 1;
+            break;
+        case ReplacementPolicy::BRRIP:
+            rrpv[set * ways + way] = (nextRandom(set) % BRRIP_LONG_INTERVAL == 0) ? RRPV_MAX - 1 : RRPV_MAX;
+            break;
+    }
+}
+
+void CachePolicy::onHit(size_t set, size_t way) {
+    switch (policy) {
+        case ReplacementPolicy::LRU:
+            lastUse[set * ways + way] = ++useClock[set];
+            break;
+        case ReplacementPolicy::PLRU:
+            if (ways > 1) touchTree(set, way);
+            break;
+        case ReplacementPolicy::SRRIP:
+        case ReplacementPolicy::BRRIP:
+            rrpv[set * ways + way] = 0;
+            break;
+        case ReplacementPolicy::FIFO:
+        case ReplacementPolicy::Random:
+            break;
+    }
+}
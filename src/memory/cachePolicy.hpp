@@ -1,16 +1,59 @@
 #ifndef CACHE_POLICY_HPP
 #define CACHE_POLICY_HPP
+/*
+  cachePolicy.hpp
+  Política de substituição da cache: escolhe a via que sai de um conjunto
+  cheio. O tipo vem da configuração de cada nível (ReplacementPolicy); o
+  estado de todas as políticas fica em vetores planos indexados por
+  conjunto * vias + via, e cada acesso custa O(1) (PLRU: O(log vias)).
 
-#include "cache.hpp"
-#include <queue> // Incluir para std::queue
+  - FIFO:  ponteiro por conjunto que avança a cada linha instalada.
+  - LRU:   carimbo de uso por linha; sai a de carimbo mais antigo.
+  - PLRU:  árvore de bits por conjunto (vias - 1 bits), apontando para o
+           lado menos usado recentemente. Exige vias em potência de 2.
+  - Random: xorshift por conjunto.
+  - SRRIP: RRPV de 2 bits por linha; entra com 2, acerto zera, sai a que
+           tiver 3 (envelhecendo o conjunto até aparecer uma).
+  - BRRIP: como o SRRIP, mas entra com 3 e só 1 em cada 32 entra com 2,
+           o que protege a cache de varreduras que não se repetem.
+
+  As chamadas de um conjunto acontecem com a trava desse conjunto, então o
+  estado é todo por conjunto (inclusive o gerador aleatório).
+*/
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../config/SimConfig.hpp"
 
 class CachePolicy {
 public:
-    CachePolicy();
-    ~CachePolicy();
+    CachePolicy(ReplacementPolicy type = ReplacementPolicy::FIFO, size_t sets = 1, size_t ways = 1);
+
+    // Via a ser substituída no conjunto (todas as vias válidas)
+    size_t victim(size_t set);
+    // Linha instalada na via
+    void onFill(size_t set, size_t way);
+    // Acerto na via
+    void onHit(size_t set, size_t way);
+
+    ReplacementPolicy type() const { return policy; }
+
+private:
+    static constexpr uint8_t RRPV_MAX = 3;
+    static constexpr uint32_t BRRIP_LONG_INTERVAL = 32;
+
+    void touchTree(size_t set, size_t way);
+    uint32_t nextRandom(size_t set);
+
+    ReplacementPolicy policy;
+    size_t ways;
 
-    // Retorna o endereço a ser substituído com base na política FIFO
-    size_t getAddressToReplace(std::queue<size_t>& fifo_queue);
+    std::vector<size_t> nextVictim;    // FIFO
+    std::vector<uint64_t> lastUse;     // LRU (por linha)
+    std::vector<uint64_t> useClock;    // LRU (por conjunto)
+    std::vector<uint8_t> tree;         // PLRU: (vias - 1) bits por conjunto
+    std::vector<uint32_t> rng;         // Random / BRRIP
+    std::vector<uint8_t> rrpv;         // SRRIP / BRRIP (por linha)
 };
 
-#endif
\ No newline at end of file
+#endif
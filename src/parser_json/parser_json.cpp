@@ -223,7 +223,14 @@ uint32_t parseInstruction(const json &instrJson, int currentInstrIndex, int star
     return encodeIType(instrJson, currentInstrIndex, startAddr);
 }
 
-int parseData(const json &dataJson, MemoryManager &memManager, PCB& pcb, int startAddr){
+// Palavra do programa: direto na memória do processo ou na imagem que o
+// MemoryManager compartilha entre processos do mesmo arquivo
+static void storeWord(MemoryManager &memManager, PCB &pcb, vector<uint32_t> *image, int addr, uint32_t word){
+    if (image) image->push_back(word);
+    else memManager.write(addr, word, pcb);
+}
+
+int parseData(const json &dataJson, MemoryManager &memManager, PCB& pcb, int startAddr, vector<uint32_t> *image){
     int addr = startAddr; 
     if (dataJson.is_object()){
         for (auto it = dataJson.begin(); it != dataJson.end(); ++it){
@@ -233,12 +240,12 @@ int parseData(const json &dataJson, MemoryManager &memManager, PCB& pcb, int sta
             if (val.is_array()){
                 for (auto &e : val){
                     int w = e.is_string()? static_cast<int>(std::stoul(e.get<string>(),nullptr,0)) : e.get<int>();
-                    memManager.write(addr, w, pcb); 
+                    storeWord(memManager, pcb, image, addr, w); 
                     addr += 4;
                 }
             } else {
                 int w = val.is_string()? static_cast<int>(std::stoul(val.get<string>(),nullptr,0)) : val.get<int>();
-                memManager.write(addr, w, pcb);
+                storeWord(memManager, pcb, image, addr, w);
                 addr += 4;
             }
         }
@@ -251,12 +258,12 @@ int parseData(const json &dataJson, MemoryManager &memManager, PCB& pcb, int sta
              if (item["value"].is_array()){
                 for (auto &v : item["value"]){
                     int w = v.is_string()? static_cast<int>(std::stoul(v.get<string>(),nullptr,0)) : v.get<int>();
-                    memManager.write(addr, w, pcb); 
+                    storeWord(memManager, pcb, image, addr, w); 
                     addr += 4;
                 }
             } else {
                 int w = item["value"].is_string()? static_cast<int>(std::stoul(item["value"].get<string>(),nullptr,0)) : item["value"].get<int>();
-                memManager.write(addr, w, pcb);
+                storeWord(memManager, pcb, image, addr, w);
                 addr += 4;
             }
         }
@@ -264,7 +271,7 @@ int parseData(const json &dataJson, MemoryManager &memManager, PCB& pcb, int sta
     return addr;
 }
 
-int parseProgram(const json &programJson, MemoryManager &memManager, PCB& pcb, int startAddr) {
+int parseProgram(const json &programJson, MemoryManager &memManager, PCB& pcb, int startAddr, vector<uint32_t> *image) {
     if (!programJson.is_array()) return startAddr;
     int current_byte_addr = startAddr; 
     
@@ -316,7 +323,7 @@ int parseProgram(const json &programJson, MemoryManager &memManager, PCB& pcb, i
     for (const auto &node : programJson) {
         if (!node.contains("instruction")) continue;
         uint32_t binary_instruction = parseInstruction(node, current_instruction_idx, startAddr);
-        memManager.write(current_mem_addr, binary_instruction, pcb);
+        storeWord(memManager, pcb, image, current_mem_addr, binary_instruction);
         current_mem_addr += 4;
         current_instruction_idx++;
     }
@@ -336,7 +343,14 @@ int loadJsonProgram(const string &filename, MemoryManager &memManager, PCB &pcb,
 
     json j = readJsonFile(filename);
     int addr = startAddr;
-    if (j.contains("data"))    addr = parseData(j["data"],    memManager, pcb, addr);
-    if (j.contains("program")) addr = parseProgram(j["program"], memManager, pcb, addr);
+    // Com imagens compartilhadas as palavras vão para um vetor e o MemoryManager
+    // só as copia para a RAM no primeiro processo deste arquivo
+    vector<uint32_t> words;
+    vector<uint32_t> *image = memManager.sharesImages() ? &words : nullptr;
+    if (j.contains("data"))    addr = parseData(j["data"],    memManager, pcb, addr, image);
+    if (j.contains("program")) addr = parseProgram(j["program"], memManager, pcb, addr, image);
+    if (image && !memManager.loadImage(pcb, filename, static_cast<uint32_t>(startAddr), words)) {
+        cerr << "[PARSER] " << filename << ": imagem carregada sem parte das paginas (disco cheio)\n";
+    }
     return addr;
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define PARSER_JSON_HPP
 
 #include <string>
+#include <vector>
 #include <nlohmann/json.hpp>
 #include "../memory/MemoryManager.hpp" // Inclui o MemoryManager correto
 #include "../cpu/PCB.hpp" 
@@ -9,11 +10,13 @@
 // Carrega um programa JSON completo para a memória usando o MemoryManager
 int loadJsonProgram(const std::string &filename, MemoryManager &memManager, PCB &pcb, int startAddr);
 
-// Faz o parsing da seção de dados
-int parseData(const nlohmann::json &dataJson, MemoryManager &memManager, PCB &pcb, int startAddr);
+// Faz o parsing da seção de dados (image != nullptr: as palavras vão para o vetor, não para a memória)
+int parseData(const nlohmann::json &dataJson, MemoryManager &memManager, PCB &pcb, int startAddr,
+              std::vector<uint32_t> *image = nullptr);
 
-// Faz o parsing das instruções
-int parseProgram(const nlohmann::json &programJson, MemoryManager &memManager, PCB &pcb, int startAddr);
+// Faz o parsing das instruções (image como em parseData)
+int parseProgram(const nlohmann::json &programJson, MemoryManager &memManager, PCB &pcb, int startAddr,
+                 std::vector<uint32_t> *image = nullptr);
 
 // Função auxiliar (pode ser usada externamente se necessário)
 uint32_t parseInstruction(const nlohmann::json &instrJson, int currentInstrIndex, int startAddr);
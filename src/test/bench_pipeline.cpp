@@ -0,0 +1,125 @@
+/*
+  bench_pipeline.cpp
+  Benchmark do laço principal do pipeline: executa um programa com laço
+  (contagem regressiva) várias vezes e mede instruções simuladas por segundo
+  de host. A saída de console do simulador é descartada durante a medição.
+
+  Uso: ./bench_pipeline [iteracoes_do_laco] [repeticoes] [forwarding 0|1] [static|bimodal|gshare]
+*/
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstdlib>
+#include <streambuf>
+#include <string>
+
+#include "cpu/PCB.hpp"
+#include "cpu/CONTROL_UNIT.hpp"
+#include "memory/MemoryManager.hpp"
+#include "IO/IOManager.hpp"
+
+static constexpr uint32_t END_SENTINEL = 0b11111100000000000000000000000000u;
+
+static uint32_t makeR(uint8_t rs, uint8_t rt, uint8_t rd, uint8_t funct) {
+    return (static_cast<uint32_t>(rs) << 21) | (static_cast<uint32_t>(rt) << 16) |
+           (static_cast<uint32_t>(rd) << 11) | (funct & 0x3Fu);
+}
+static uint32_t makeI(uint8_t opcode, uint8_t rs, uint8_t rt, uint16_t imm) {
+    return (static_cast<uint32_t>(opcode & 0x3F) << 26) | (static_cast<uint32_t>(rs) << 21) |
+           (static_cast<uint32_t>(rt) << 16) | imm;
+}
+
+// Descarta tudo que for escrito no stream
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+int main(int argc, char** argv) {
+    const int loopIterations = argc > 1 ? std::atoi(argv[1]) : 2000;
+    const int repetitions = argc > 2 ? std::atoi(argv[2]) : 20;
+    const bool forwarding = argc > 3 ? std::atoi(argv[3]) != 0 : true;
+    const std::string predictorName = argc > 4 ? argv[4] : "bimodal";
+
+    PipelineConfig pipelineConfig;
+    pipelineConfig.forwarding = forwarding;
+    if (predictorName == "static") pipelineConfig.branchPredictor.type = BranchPredictorType::StaticNotTaken;
+    else if (predictorName == "gshare") pipelineConfig.branchPredictor.type = BranchPredictorType::Gshare;
+    else pipelineConfig.branchPredictor.type = BranchPredictorType::Bimodal;
+
+    // t0 = contador, t1 = acumulador, t2 = soma dos acumuladores
+    const uint8_t zero = 0, t0 = 8, t1 = 9, t2 = 10;
+    const std::vector<uint32_t> program = {
+        makeI(0x0E, zero, t0, static_cast<uint16_t>(loopIterations)), //  0: li   t0, N
+        makeI(0x08, t1, t1, 1),                                        //  4: addi t1, t1, 1
+        makeR(t2, t1, t2, 0x20),                                       //  8: add  t2, t2, t1
+        makeI(0x08, t0, t0, static_cast<uint16_t>(-1)),                // 12: addi t0, t0, -1
+        makeI(0x05, t0, zero, 4),                                      // 16: bne  t0, zero, 4
+        END_SENTINEL                                                   // 20: end
+    };
+    const uint64_t instructionsPerRun = 1 + 4ull * loopIterations + 1;
+
+    NullBuffer nullBuffer;
+    std::streambuf* coutBuffer = std::cout.rdbuf(&nullBuffer);
+
+    uint64_t totalCycles = 0;
+    uint64_t totalRetired = 0, totalBubbles = 0, totalAvoided = 0;
+    uint64_t totalBranches = 0, totalMispredictions = 0;
+    uint64_t totalTlbHits = 0, totalTlbMisses = 0;
+    int32_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int r = 0; r < repetitions; ++r) {
+        MemoryManager memManager(1024, 8192);
+        PCB pcb{};
+        pcb.pid = 1;
+        pcb.quantum = 1 << 30;
+        for (size_t i = 0; i < program.size(); ++i) {
+            memManager.write(static_cast<uint32_t>(i * 4), program[i], pcb);
+        }
+
+        std::vector<std::unique_ptr<IORequest>> ioRequests;
+        bool printLock = false;
+        Control_Unit UC;
+        UC.configure(pipelineConfig);
+        UC.port = memManager.attachCore();
+        Core(UC, memManager, pcb, &ioRequests, printLock);
+
+        totalCycles += pcb.pipeline_cycles.load();
+        totalRetired += pcb.instructions_retired.load();
+        totalBubbles += pcb.stall_bubbles.load();
+        totalAvoided += pcb.bubbles_avoided.load();
+        totalBranches += pcb.branches.load();
+        totalMispredictions += pcb.branch_mispredictions.load();
+        totalTlbHits += pcb.tlb_hits.load();
+        totalTlbMisses += pcb.tlb_misses.load();
+        checksum = static_cast<int32_t>(pcb.regBank.read(t2));
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    std::cout.rdbuf(coutBuffer);
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    uint64_t totalInstructions = instructionsPerRun * repetitions;
+
+    std::cout << "=== Benchmark do Pipeline ===\n";
+    std::cout << "Iteracoes do laco:       " << loopIterations << "\n";
+    std::cout << "Repeticoes:              " << repetitions << "\n";
+    std::cout << "Forwarding:              " << (forwarding ? "sim" : "nao (so stall)") << "\n";
+    std::cout << "Preditor de desvios:     " << predictorName << "\n";
+    std::cout << "Checksum (t2):           " << checksum << "\n";
+    std::cout << "Instrucoes simuladas:    " << totalInstructions << "\n";
+    std::cout << "Ciclos simulados:        " << totalCycles << "\n";
+    std::cout << "CPI:                     " << (totalRetired ? static_cast<double>(totalCycles) / totalRetired : 0.0) << "\n";
+    std::cout << "Bolhas inseridas:        " << totalBubbles << "\n";
+    std::cout << "Bolhas evitadas:         " << totalAvoided << "\n";
+    std::cout << "Desvios / erros:         " << totalBranches << " / " << totalMispredictions << "\n";
+    std::cout << "TLB hits / misses:       " << totalTlbHits << " / " << totalTlbMisses << "\n";
+    std::cout << "Tempo de host:           " << seconds << " s\n";
+    std::cout << "Instrucoes / s de host:  " << static_cast<uint64_t>(totalInstructions / seconds) << "\n";
+    std::cout << "Ciclos / s de host:      " << static_cast<uint64_t>(totalCycles / seconds) << "\n";
+    return 0;
+}
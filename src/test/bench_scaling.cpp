@@ -0,0 +1,124 @@
+/*
+  bench_scaling.cpp
+  Benchmark de escalabilidade do MemoryManager: o mesmo lote de processos
+  (cada um com um laço de LW/ADDI/SW sobre a sua página de dados) é executado
+  com 1, 2, 4 e 8 núcleos, cada núcleo com o seu Control_Unit e TLB, todos
+  compartilhando um único MemoryManager. Mede o tempo de host de cada rodada
+  e conta as transações no barramento de coerência das L1.
+
+  Não usa o batch.json: os processos de lá dormem esperando IO, o que
+  esconderia o custo da memória. A saída de console do simulador é descartada.
+
+  Uso: ./bench_scaling [processos] [iteracoes_do_laco]
+*/
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <streambuf>
+
+#include "cpu/PCB.hpp"
+#include "cpu/CONTROL_UNIT.hpp"
+#include "memory/MemoryManager.hpp"
+#include "IO/IOManager.hpp"
+
+static constexpr uint32_t END_SENTINEL = 0b11111100000000000000000000000000u;
+
+static uint32_t makeI(uint8_t opcode, uint8_t rs, uint8_t rt, uint16_t imm) {
+    return (static_cast<uint32_t>(opcode & 0x3F) << 26) | (static_cast<uint32_t>(rs) << 21) |
+           (static_cast<uint32_t>(rt) << 16) | imm;
+}
+
+// Descarta tudo que for escrito no stream
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+int main(int argc, char** argv) {
+    const int processCount = argc > 1 ? std::atoi(argv[1]) : 16;
+    const int loopIterations = argc > 2 ? std::atoi(argv[2]) : 2000;
+    const int coreCounts[] = {1, 2, 4, 8};
+
+    // Código na página 0, contador na página 1 (endereço 32)
+    const uint8_t zero = 0, t0 = 8, t1 = 9;
+    const uint16_t DATA_ADDR = static_cast<uint16_t>(PAGE_SIZE);
+    const std::vector<uint32_t> program = {
+        makeI(0x0E, zero, t0, static_cast<uint16_t>(loopIterations)), //  0: li   t0, N
+        makeI(0x23, zero, t1, DATA_ADDR),                              //  4: lw   t1, 32
+        makeI(0x08, t1, t1, 1),                                        //  8: addi t1, t1, 1
+        makeI(0x2B, zero, t1, DATA_ADDR),                              // 12: sw   t1, 32
+        makeI(0x08, t0, t0, static_cast<uint16_t>(-1)),               // 16: addi t0, t0, -1
+        makeI(0x05, t0, zero, 4),                                      // 20: bne  t0, zero, 4
+        END_SENTINEL                                                   // 24: end
+    };
+
+    NullBuffer nullBuffer;
+    std::streambuf* coutBuffer = std::cout.rdbuf(&nullBuffer);
+
+    std::vector<double> seconds;
+    std::vector<bool> correct;
+    std::vector<uint64_t> busTransactions;
+    for (int cores : coreCounts) {
+        MemoryManager memManager(1024, 8192);
+        std::vector<std::unique_ptr<PCB>> processes;
+        for (int p = 0; p < processCount; ++p) {
+            auto pcb = std::make_unique<PCB>();
+            pcb->pid = p + 1;
+            pcb->quantum = 1 << 30;
+            for (size_t i = 0; i < program.size(); ++i) {
+                memManager.write(static_cast<uint32_t>(i * 4), program[i], *pcb);
+            }
+            memManager.write(DATA_ADDR, 0, *pcb);
+            processes.push_back(std::move(pcb));
+        }
+
+        std::atomic<int> next{0};
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (int c = 0; c < cores; ++c) {
+            threads.emplace_back([&]() {
+                Control_Unit UC;
+                UC.port = memManager.attachCore();
+                std::vector<std::unique_ptr<IORequest>> ioRequests;
+                bool printLock = false;
+                for (int p = next.fetch_add(1); p < processCount; p = next.fetch_add(1)) {
+                    Core(UC, memManager, *processes[p], &ioRequests, printLock);
+                }
+            });
+        }
+        for (auto& t : threads) t.join();
+        auto end = std::chrono::steady_clock::now();
+        seconds.push_back(std::chrono::duration<double>(end - start).count());
+
+        bool ok = true;
+        uint64_t bus = 0;
+        for (auto& pcb : processes) {
+            bus += pcb->bus_transactions.load();
+            ok = ok && memManager.read(DATA_ADDR, *pcb) == static_cast<uint32_t>(loopIterations);
+        }
+        correct.push_back(ok);
+        busTransactions.push_back(bus);
+    }
+
+    std::cout.rdbuf(coutBuffer);
+
+    std::cout << "=== Benchmark de Escalabilidade (MemoryManager) ===\n";
+    std::cout << "Processos:               " << processCount << "\n";
+    std::cout << "Iteracoes do laco:       " << loopIterations << "\n";
+    bool allCorrect = true;
+    for (size_t i = 0; i < seconds.size(); ++i) {
+        std::cout << "Nucleos: " << coreCounts[i]
+                  << " | Tempo de host: " << seconds[i] << " s"
+                  << " | Speedup: " << seconds[0] / seconds[i]
+                  << " | Transacoes de barramento: " << busTransactions[i]
+                  << (correct[i] ? "" : " | RESULTADO INCORRETO") << "\n";
+        allCorrect = allCorrect && correct[i];
+    }
+    return allCorrect ? 0 : 1;
+}
@@ -42,6 +42,8 @@ int main() {
         std::cerr << "[WARN] Falha ao carregar process1.json. Usando valores padrão.\n";
         pcb.pid = 1; pcb.name = "fallback"; pcb.quantum = 50; pcb.priority = 0;
     }
+    // O JSON não traz quantum; sem ele o Core para (e salva o pipeline) no primeiro ciclo
+    if (pcb.quantum <= 0) pcb.quantum = 50;
 
     // Agora precisamos de um MemoryManager em vez de uma MainMemory
     MemoryManager memManager(1024, 8192);
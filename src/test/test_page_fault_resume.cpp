@@ -0,0 +1,123 @@
+/*
+  test_page_fault_resume.cpp
+  Falta de página assíncrona durante o esvaziamento do pipeline (depois do END).
+
+  O laço termina com o desvio previsto como tomado (o BTB aprendeu nas voltas
+  anteriores) e o SW seguinte cai numa página fora da RAM. Com paginação
+  assíncrona o processo bloqueia no WB do SW com o END já decodificado; a
+  retomada tem que continuar o esvaziamento, sem decodificar de novo o anel
+  nem buscar outra vez as instruções depois do desvio. O resultado deve ser
+  o mesmo da paginação síncrona.
+*/
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "cpu/PCB.hpp"
+#include "cpu/CONTROL_UNIT.hpp"
+#include "cpu/REGISTER_BANK.hpp"
+#include "memory/MemoryManager.hpp"
+#include "IO/IOManager.hpp"
+#include "trace/Console.hpp"
+
+static constexpr uint32_t END_SENTINEL = 0b11111100000000000000000000000000u;
+static constexpr uint32_t STORE_ADDRESS = 2 * PAGE_SIZE;   // página 2: fora dos dois frames
+
+static uint32_t makeI(uint8_t opcode, uint8_t rs, uint8_t rt, uint16_t imm) {
+    return (static_cast<uint32_t>(opcode & 0x3F) << 26) | (static_cast<uint32_t>(rs) << 21) |
+           (static_cast<uint32_t>(rt) << 16) | imm;
+}
+
+struct RunResult {
+    uint64_t retired;
+    uint64_t writes;
+    uint64_t blocks;
+    uint32_t stored;
+    bool finished;
+};
+
+static RunResult run(bool async) {
+    MemoryConfig config;
+    config.mainMemoryBytes = 2 * PAGE_SIZE;
+    config.paging.async = async;
+    MemoryManager memManager(config.mainMemoryBytes, 8192, config);
+
+    auto& mapper = hw::getGlobalRegisterMapper();
+    uint8_t r_zero = hw::RegisterMapper::indexFromBinary(mapper.getRegisterBinary("zero"));
+    uint8_t r_t1 = hw::RegisterMapper::indexFromBinary(mapper.getRegisterBinary("t1"));
+    uint8_t r_t2 = hw::RegisterMapper::indexFromBinary(mapper.getRegisterBinary("t2"));
+
+    PCB pcb{};
+    pcb.pid = 1;
+    pcb.quantum = 1000;
+    memManager.write(0, makeI(0x0E, r_zero, r_t1, 3), pcb);        // li   t1, 3
+    memManager.write(4, makeI(0x08, r_t1, r_t1, 0xFFFF), pcb);     // addi t1, t1, -1
+    memManager.write(8, makeI(0x05, r_t1, r_zero, 4), pcb);        // bne  t1, zero, 4
+    memManager.write(12, makeI(0x0E, r_zero, r_t2, 9), pcb);       // li   t2, 9
+    memManager.write(16, makeI(0x2B, r_zero, r_t2, STORE_ADDRESS), pcb); // sw   t2, 64
+    memManager.write(20, END_SENTINEL, pcb);
+    // Dado na página 1: os dois frames ficam ocupados e o SW precisa de swap
+    memManager.write(2 * PAGE_SIZE - 4, 0, pcb);
+    uint64_t loaderWrites = pcb.mem_writes.load();
+
+    Control_Unit UC;
+    UC.port = memManager.attachCore();
+    std::vector<std::unique_ptr<IORequest>> ioRequests;
+    bool printLock = false;
+
+    for (int slice = 0; slice < 100 && pcb.state != State::Finished; ++slice) {
+        pcb.state = State::Running;
+        Core(UC, memManager, pcb, &ioRequests, printLock);
+        if (pcb.state == State::Blocked && pcb.pending_page >= 0) {
+            memManager.startPageIn(pcb);
+            while (pcb.state != State::Ready) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    RunResult result;
+    result.retired = pcb.instructions_retired.load();
+    result.writes = pcb.mem_writes.load() - loaderWrites;
+    result.blocks = pcb.page_fault_blocks.load();
+    result.stored = memManager.read(STORE_ADDRESS, pcb);
+    result.finished = pcb.state == State::Finished;
+    return result;
+}
+
+int main() {
+    trace::ConsoleLevels off{};
+    trace::set_console_levels(off);
+
+    RunResult sync = run(false);
+    RunResult async = run(true);
+
+    std::cout << "sincrona:   retiradas=" << sync.retired << " escritas=" << sync.writes
+              << " valor=" << sync.stored << "\n";
+    std::cout << "assincrona: retiradas=" << async.retired << " escritas=" << async.writes
+              << " valor=" << async.stored << " bloqueios=" << async.blocks << "\n";
+
+    int failures = 0;
+    if (!sync.finished || !async.finished) {
+        std::cerr << "[FALHA] processo nao terminou\n";
+        ++failures;
+    }
+    if (async.blocks == 0) {
+        std::cerr << "[FALHA] o SW nao bloqueou o processo (teste nao exercita a retomada)\n";
+        ++failures;
+    }
+    if (async.retired != sync.retired) {
+        std::cerr << "[FALHA] instrucoes retiradas diferem da execucao sincrona\n";
+        ++failures;
+    }
+    // A tentativa que bloqueou e a que completa na retomada
+    if (async.writes != sync.writes + async.blocks) {
+        std::cerr << "[FALHA] escritas repetidas na retomada\n";
+        ++failures;
+    }
+    if (sync.stored != 9 || async.stored != 9) {
+        std::cerr << "[FALHA] valor gravado errado\n";
+        ++failures;
+    }
+    return failures == 0 ? 0 : 1;
+}
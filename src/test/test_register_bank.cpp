@@ -85,6 +85,47 @@ void utilsTest_Bank(){
     }
 }
 
+// Função para testar o acesso por índice e a consistência com o acesso por nome
+void indexAccessTest_Bank(){
+    cout << "\n=== Index Access Test (REGISTER_BANK) ===\n";
+    REGISTER_BANK banco;
+
+    // Teste 1: escrita por índice, leitura por nome ($8 = t0, $25 = t9, $31 = ra)
+    banco.write(8, 7);
+    banco.write(25, 11);
+    banco.write(31, 13);
+    cout << "Escrevendo 7/11/13 nos indices 8/25/31 e lendo por nome... ";
+    if (banco.readRegister("t0") == 7 && banco.readRegister("t9") == 11 && banco.readRegister("ra") == 13){
+        cout << "OK.\n";
+    } else{
+        cout << "FALHA.\n";
+    }
+
+    // Teste 2: escrita por nome, leitura por índice
+    banco.writeRegister("s3", 99);
+    cout << "Valor lido do indice 19 apos escrever 99 em 's3': " << banco.read(19) << " (esperado: 99)\n";
+
+    // Teste 3: proteção do $zero também no caminho por índice
+    banco.write(0, 123);
+    if (banco.read(0) == 0){
+        cout << "  -> SUCESSO: O indice 0 permaneceu 0.\n";
+    } else{
+        cout << "  -> FALHA: O indice 0 foi modificado!\n";
+    }
+
+    // Teste 4: nome <-> índice
+    bool nomesOk = true;
+    for (uint8_t i = 0; i < REGISTER_BANK::NUM_GPR; ++i){
+        if (REGISTER_BANK::gprIndex(REGISTER_BANK::gprName(i)) != i) nomesOk = false;
+    }
+    cout << "Conversao nome <-> indice dos 32 registradores: " << (nomesOk ? "OK" : "FALHA") << "\n";
+
+    // Teste 5: a cópia do banco (troca de contexto) preserva os valores
+    REGISTER_BANK copia = banco;
+    banco.write(8, 0);
+    cout << "Valor de 't0' na copia apos alterar o original: " << copia.readRegister("t0") << " (esperado: 7)\n";
+}
+
 
 int main(){
     cout << "===============================================\n";
@@ -95,6 +136,7 @@ int main(){
         basicFunctionalityTest_Bank();
         rulesAndErrorHandlingTest_Bank();
         utilsTest_Bank();
+        indexAccessTest_Bank();
 
         cout << "\n=== Todos os testes do REGISTER_BANK passaram com sucesso! ===\n";
 
@@ -0,0 +1,43 @@
+#include "Console.hpp"
+
+#include <iostream>
+#include <mutex>
+
+namespace trace {
+
+static std::mutex console_mutex;
+
+void set_console_levels(const ConsoleLevels &levels) {
+    for (size_t i = 0; i < CATEGORY_COUNT; ++i) {
+        Level level = levels[i] < COMPILED_LEVELS[i] ? levels[i] : COMPILED_LEVELS[i];
+        g_consoleLevels[i].store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+    }
+}
+
+bool category_from_name(const std::string &name, Category &out) {
+    static const char *const NAMES[CATEGORY_COUNT] = {
+        "decode", "branch", "memory", "mmu", "swap", "io", "scheduler"
+    };
+    for (size_t i = 0; i < CATEGORY_COUNT; ++i) {
+        if (name == NAMES[i]) {
+            out = static_cast<Category>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool level_from_name(const std::string &name, Level &out) {
+    if (name == "off") { out = Level::Off; return true; }
+    if (name == "info") { out = Level::Info; return true; }
+    if (name == "debug") { out = Level::Debug; return true; }
+    return false;
+}
+
+ConsoleLine::~ConsoleLine() {
+    const std::string text = buffer_.str();
+    std::lock_guard<std::mutex> lock(console_mutex);
+    std::cout << text;
+}
+
+} // namespace trace
@@ -0,0 +1,117 @@
+#ifndef TRACE_CONSOLE_HPP
+#define TRACE_CONSOLE_HPP
+/*
+  Console.hpp
+  Mensagens de acompanhamento no console ([DECODE], [BRANCH], [MMU], ...).
+
+  Cada mensagem pertence a uma categoria e tem um nível (Info para eventos
+  raros, Debug para os que acontecem a cada instrução). O nível máximo de
+  cada categoria é fixado na compilação (SIM_TRACE_<CATEGORIA>, definido pelo
+  CMake a partir de SIM_CONSOLE_TRACE); uma mensagem acima dele some do
+  binário, porque SIM_TRACE a envolve num "if constexpr". Para as categorias
+  compiladas, o nível ainda pode ser reduzido em tempo de execução pela seção
+  "trace" do batch.json.
+
+  Uso:
+    SIM_TRACE(Decode, Debug, "[DECODE] PC: " << pc << "\n");
+
+  A linha é montada num buffer e escrita inteira no std::cout, então
+  mensagens de núcleos diferentes não se misturam no meio da linha.
+*/
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+// Nível máximo compilado de cada categoria: 0 = desligada, 1 = Info, 2 = Debug
+#ifndef SIM_TRACE_DECODE
+#define SIM_TRACE_DECODE 2
+#endif
+#ifndef SIM_TRACE_BRANCH
+#define SIM_TRACE_BRANCH 2
+#endif
+#ifndef SIM_TRACE_MEMORY
+#define SIM_TRACE_MEMORY 2
+#endif
+#ifndef SIM_TRACE_MMU
+#define SIM_TRACE_MMU 2
+#endif
+#ifndef SIM_TRACE_SWAP
+#define SIM_TRACE_SWAP 2
+#endif
+#ifndef SIM_TRACE_IO
+#define SIM_TRACE_IO 2
+#endif
+#ifndef SIM_TRACE_SCHEDULER
+#define SIM_TRACE_SCHEDULER 2
+#endif
+
+namespace trace {
+
+enum class Category : uint8_t { Decode, Branch, Memory, Mmu, Swap, Io, Scheduler, COUNT };
+enum class Level : uint8_t { Off = 0, Info = 1, Debug = 2 };
+
+inline constexpr size_t CATEGORY_COUNT = static_cast<size_t>(Category::COUNT);
+
+using ConsoleLevels = std::array<Level, CATEGORY_COUNT>;
+
+inline constexpr ConsoleLevels COMPILED_LEVELS = {
+    static_cast<Level>(SIM_TRACE_DECODE),
+    static_cast<Level>(SIM_TRACE_BRANCH),
+    static_cast<Level>(SIM_TRACE_MEMORY),
+    static_cast<Level>(SIM_TRACE_MMU),
+    static_cast<Level>(SIM_TRACE_SWAP),
+    static_cast<Level>(SIM_TRACE_IO),
+    static_cast<Level>(SIM_TRACE_SCHEDULER),
+};
+
+// A mensagem existe no binário?
+constexpr bool compiled(Category category, Level level) {
+    return level <= COMPILED_LEVELS[static_cast<size_t>(category)];
+}
+
+// Níveis em tempo de execução (começam iguais aos compilados)
+inline std::atomic<uint8_t> g_consoleLevels[CATEGORY_COUNT] = {
+    {SIM_TRACE_DECODE}, {SIM_TRACE_BRANCH}, {SIM_TRACE_MEMORY}, {SIM_TRACE_MMU},
+    {SIM_TRACE_SWAP}, {SIM_TRACE_IO}, {SIM_TRACE_SCHEDULER},
+};
+
+inline bool enabled(Category category, Level level) {
+    return static_cast<uint8_t>(level) <=
+           g_consoleLevels[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+}
+
+// Aplica os níveis pedidos; nenhum passa do nível compilado
+void set_console_levels(const ConsoleLevels &levels);
+
+// "decode", "branch", ... -> Category; false se o nome não existir
+bool category_from_name(const std::string &name, Category &out);
+// "off", "info", "debug" -> Level; false se o nome não existir
+bool level_from_name(const std::string &name, Level &out);
+
+// Acumula uma linha e a escreve de uma vez no std::cout ao ser destruída
+class ConsoleLine {
+public:
+    ~ConsoleLine();
+    template <typename T>
+    ConsoleLine &operator<<(const T &value) { buffer_ << value; return *this; }
+    ConsoleLine &operator<<(std::ostream &(*manip)(std::ostream &)) { manip(buffer_); return *this; }
+private:
+    std::ostringstream buffer_;
+};
+
+} // namespace trace
+
+#define SIM_TRACE(category, level, message)                                                        \
+    do {                                                                                           \
+        if constexpr (::trace::compiled(::trace::Category::category, ::trace::Level::level)) {     \
+            if (::trace::enabled(::trace::Category::category, ::trace::Level::level)) {            \
+                ::trace::ConsoleLine sim_trace_line_;                                              \
+                sim_trace_line_ << message;                                                        \
+            }                                                                                      \
+        }                                                                                          \
+    } while (0)
+
+#endif // TRACE_CONSOLE_HPP
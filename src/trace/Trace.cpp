@@ -0,0 +1,173 @@
+#include "Trace.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "../cpu/MicroOp.hpp"
+#include "../cpu/REGISTER_BANK.hpp"
+
+namespace trace {
+
+size_t Ring::pop(Record *out, size_t max) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    size_t available = head_.load(std::memory_order_acquire) - tail;
+    size_t count = available < max ? available : max;
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = slots_[(tail + i) & (CAPACITY - 1)];
+    }
+    tail_.store(tail + count, std::memory_order_release);
+    return count;
+}
+
+Tracer &Tracer::instance() {
+    static Tracer tracer;
+    return tracer;
+}
+
+bool Tracer::start(const std::string &path) {
+    if (active()) stop();
+
+    file_ = std::fopen(path.c_str(), "wb");
+    if (file_ == nullptr) {
+        std::cerr << "[TRACE] Nao foi possivel abrir " << path << "\n";
+        return false;
+    }
+    FileHeader header;
+    std::fwrite(&header, sizeof(header), 1, file_);
+
+    {
+        // Anéis da execução anterior são descartados; as threads registram novos
+        std::lock_guard<std::mutex> lock(ringsMutex_);
+        rings_.clear();
+        generation_.fetch_add(1, std::memory_order_acq_rel);
+    }
+    written_ = 0;
+    stopRequested_.store(false);
+    active_.store(true, std::memory_order_release);
+    writer_ = std::thread(&Tracer::writerLoop, this);
+    return true;
+}
+
+void Tracer::stop() {
+    if (!active()) return;
+    active_.store(false, std::memory_order_release);
+    stopRequested_.store(true);
+    if (writer_.joinable()) writer_.join();
+
+    drainOnce();
+    std::fclose(file_);
+    file_ = nullptr;
+
+    uint64_t lost = dropped();
+    if (lost > 0) {
+        std::cerr << "[TRACE] " << lost << " registros descartados (anel cheio)\n";
+    }
+}
+
+Ring *Tracer::localRing() {
+    thread_local Ring *ring = nullptr;
+    thread_local uint64_t ringGeneration = 0;
+
+    uint64_t current = generation_.load(std::memory_order_acquire);
+    if (ring != nullptr && ringGeneration == current) return ring;
+
+    std::lock_guard<std::mutex> lock(ringsMutex_);
+    rings_.push_back(std::make_unique<Ring>());
+    ring = rings_.back().get();
+    ringGeneration = current;
+    return ring;
+}
+
+uint64_t Tracer::dropped() const {
+    std::lock_guard<std::mutex> lock(ringsMutex_);
+    uint64_t total = 0;
+    for (const auto &ring : rings_) total += ring->dropped();
+    return total;
+}
+
+size_t Tracer::drainOnce() {
+    static constexpr size_t BATCH = 1024;
+    Record batch[BATCH];
+
+    std::vector<Ring *> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex_);
+        snapshot.reserve(rings_.size());
+        for (const auto &ring : rings_) snapshot.push_back(ring.get());
+    }
+
+    size_t total = 0;
+    for (Ring *ring : snapshot) {
+        size_t n;
+        while ((n = ring->pop(batch, BATCH)) > 0) {
+            std::fwrite(batch, sizeof(Record), n, file_);
+            total += n;
+        }
+    }
+    written_ += total;
+    return total;
+}
+
+void Tracer::writerLoop() {
+    while (!stopRequested_.load()) {
+        if (drainOnce() == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+bool load(const std::string &path, std::vector<Record> &records) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return false;
+
+    FileHeader expected;
+    FileHeader header;
+    in.read(reinterpret_cast<char *>(&header), sizeof(header));
+    if (!in || std::string(header.magic, 8) != std::string(expected.magic, 8) ||
+        header.recordSize != sizeof(Record)) {
+        std::cerr << "[TRACE] Arquivo de trace invalido: " << path << "\n";
+        return false;
+    }
+
+    Record record;
+    while (in.read(reinterpret_cast<char *>(&record), sizeof(record))) {
+        records.push_back(record);
+    }
+    return true;
+}
+
+std::string render_record(const Record &record) {
+    const Opcode op = static_cast<Opcode>(record.opcode);
+    const char *dst = hw::REGISTER_BANK::gprName(record.dst);
+    const char *src1 = hw::REGISTER_BANK::gprName(record.src1);
+    const char *src2 = hw::REGISTER_BANK::gprName(record.src2);
+
+    std::ostringstream ss;
+    switch (record.event) {
+        case Event::Alu:
+            switch (op) {
+                case Opcode::ADDI: case Opcode::ADDIU:
+                    ss << "[IMM] " << opcodeName(op) << " " << dst << " = " << src1 << "(" << record.a << ") + " << record.b << " -> " << record.result;
+                    break;
+                case Opcode::SLTI:
+                    ss << "[IMM] SLTI " << dst << " = (" << src1 << "(" << record.a << ") < " << record.b << ") ? 1 : 0 -> " << record.result;
+                    break;
+                case Opcode::LUI:
+                    ss << "[IMM] LUI " << dst << " = (0x" << std::hex << record.b << " << 16) -> 0x" << record.result << std::dec;
+                    break;
+                case Opcode::LI:
+                    ss << "[IMM] LI " << dst << " = " << record.b;
+                    break;
+                default:
+                    ss << "[ARIT] " << opcodeName(op) << " " << dst << " = " << src1 << "(" << record.a << ") " << opcodeName(op) << " " << src2 << "(" << record.b << ") = " << record.result;
+                    break;
+            }
+            break;
+    }
+    ss << " [PID:" << record.pid << "]";
+    return ss.str();
+}
+
+} // namespace trace
@@ -0,0 +1,136 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+/*
+  Trace.hpp
+  Registro (trace) das operações executadas pelos núcleos.
+
+  O caminho quente (emit) não aloca nem faz IO: cada thread que gera eventos
+  ganha, no primeiro uso, um anel SPSC de registros binários de tamanho fixo.
+  Uma thread de escrita esvazia os anéis periodicamente num único arquivo por
+  execução (output/trace_logs/trace.bin). Se um anel encher, o registro é
+  descartado e contado, nunca bloqueando o núcleo.
+
+  O texto legível ("[IMM] ADDI t1 = ...") é gerado depois, a partir do arquivo,
+  por render_record(): o simulador usa isso para montar a seção de operações de
+  output_<pid>.dat e a ferramenta trace_render imprime o arquivo inteiro.
+*/
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace trace {
+
+// Tipo do evento registrado
+enum class Event : uint8_t {
+    Alu = 0     // instrução de ULA / imediato executada no EX
+};
+
+// Registro binário de tamanho fixo gravado no arquivo
+struct Record {
+    uint64_t cycle = 0;     // ciclo de pipeline do processo
+    int32_t pid = 0;
+    uint32_t pc = 0;
+    Event event = Event::Alu;
+    uint8_t opcode = 0;     // Opcode (ISA.hpp)
+    uint8_t dst = 0;        // registrador escrito
+    uint8_t src1 = 0;       // registradores lidos
+    uint8_t src2 = 0;
+    uint8_t pad[3] = {0, 0, 0};
+    int32_t a = 0;          // operandos e resultado
+    int32_t b = 0;
+    int32_t result = 0;
+};
+static_assert(sizeof(Record) == 40, "trace::Record deve ter tamanho fixo");
+
+// Cabeçalho do arquivo de trace
+struct FileHeader {
+    char magic[8] = {'M', 'I', 'P', 'S', 'T', 'R', 'C', '1'};
+    uint32_t version = 1;
+    uint32_t recordSize = sizeof(Record);
+};
+
+// Anel de um produtor (a thread do núcleo) e um consumidor (a thread de escrita)
+class Ring {
+public:
+    static constexpr size_t CAPACITY = 1u << 14;
+
+    bool push(const Record &record) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) >= CAPACITY) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        slots_[head & (CAPACITY - 1)] = record;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Copia até max registros para out; devolve quantos foram copiados
+    size_t pop(Record *out, size_t max);
+
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::array<Record, CAPACITY> slots_;
+};
+
+class Tracer {
+public:
+    static Tracer &instance();
+
+    // Abre o arquivo da execução e inicia a thread de escrita
+    bool start(const std::string &path);
+    // Para a thread de escrita, esvazia os anéis e fecha o arquivo
+    void stop();
+
+    bool active() const { return active_.load(std::memory_order_relaxed); }
+
+    // Anel da thread atual (criado no primeiro uso de cada execução)
+    Ring *localRing();
+
+    uint64_t written() const { return written_; }
+    uint64_t dropped() const;
+
+private:
+    Tracer() = default;
+    void writerLoop();
+    size_t drainOnce();
+
+    std::atomic<bool> active_{false};
+    std::atomic<bool> stopRequested_{false};
+    std::atomic<uint64_t> generation_{0};
+
+    mutable std::mutex ringsMutex_;
+    std::vector<std::unique_ptr<Ring>> rings_;
+
+    std::FILE *file_ = nullptr;
+    std::thread writer_;
+    uint64_t written_ = 0;
+};
+
+// Caminho quente: grava o registro no anel da thread, se o trace estiver ativo
+inline void emit(const Record &record) {
+    Tracer &tracer = Tracer::instance();
+    if (!tracer.active()) return;
+    if (Ring *ring = tracer.localRing()) ring->push(record);
+}
+
+// Lê todos os registros de um arquivo de trace
+bool load(const std::string &path, std::vector<Record> &records);
+
+// Texto legível de um registro, no mesmo formato do antigo log por processo
+std::string render_record(const Record &record);
+
+} // namespace trace
+
+#endif // TRACE_HPP
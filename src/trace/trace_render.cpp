@@ -0,0 +1,43 @@
+/*
+  trace_render.cpp
+  Ferramenta offline: lê o trace binário de uma execução e imprime as
+  operações em texto, agrupadas por processo e na ordem de execução.
+
+  Uso: ./trace_render [output/trace_logs/trace.bin] [pid]
+*/
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "trace/Trace.hpp"
+
+int main(int argc, char **argv) {
+    const std::string path = argc > 1 ? argv[1] : "output/trace_logs/trace.bin";
+    const bool filterPid = argc > 2;
+    const int pid = filterPid ? std::atoi(argv[2]) : 0;
+
+    std::vector<trace::Record> records;
+    if (!trace::load(path, records)) {
+        std::cerr << "Nao foi possivel ler " << path << "\n";
+        return 1;
+    }
+
+    std::stable_sort(records.begin(), records.end(), [](const trace::Record &x, const trace::Record &y) {
+        return x.pid != y.pid ? x.pid < y.pid : x.cycle < y.cycle;
+    });
+
+    int currentPid = -1;
+    bool first = true;
+    for (const trace::Record &record : records) {
+        if (filterPid && record.pid != pid) continue;
+        if (first || record.pid != currentPid) {
+            currentPid = record.pid;
+            first = false;
+            std::cout << "=== PID " << currentPid << " ===\n";
+        }
+        std::cout << trace::render_record(record) << "\n";
+    }
+    return 0;
+}